@@ -45,7 +45,7 @@ fi
 
 # Make Python scripts executable
 echo -e "${GREEN}Making Python scripts executable...${NC}"
-chmod +x lan8651_kernelfs.py
+chmod +x lan8651_kernelfs.py lan8651_top.py
 
 # Check file sizes and permissions
 echo -e "${GREEN}Build summary:${NC}"
@@ -1,8 +1,9 @@
 // SPDX-License-Identifier: GPL-2.0+
 /*
- * LAN8651 Register Access via existing network interface
- * 
- * Uses ethtool private ioctls for register access
+ * LAN8651 Register Access via the lan865x generic netlink family
+ *
+ * Interfaces are enumerated over rtnetlink, registers are accessed
+ * in batches with one netlink round trip per command
  * No need for separate kernel module
  */
 
@@ -11,13 +12,15 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
-#include <sys/ioctl.h>
 #include <linux/if.h>
-#include <linux/sockios.h>
-#include <linux/ethtool.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/genetlink.h>
 #include <errno.h>
 #include <time.h>
 
+#include "../lan865x_nl.h"
+
 /* Debug output control */
 #ifndef DEBUG_ENABLED
 #define DEBUG_ENABLED 0  /* Set to 1 to enable debug output */
@@ -47,263 +50,584 @@
 #define DEBUG_HEX_DUMP(data, len) do { } while(0)
 #endif
 
-#define MAX_INTERFACES 10
+#define LINK_LIST_MIN 16
+#define MAX_BLOCKS 64
+#define NL_BUF_SIZE 65536
+
+struct nl_msg {
+    union {
+        struct nlmsghdr nlh;
+        char buf[NL_BUF_SIZE];
+    };
+};
+
+struct nl_sock {
+    int fd;
+    __u32 seq;
+};
 
-struct lan8651_reg_access {
-    __u32 cmd;
+struct lan8651_iface {
+    int ifindex;
+    char name[IFNAMSIZ];
+};
+
+struct lan8651_block {
     __u32 address;
-    __u32 value;
+    __u32 count;
+    __u32 *values;
 };
 
-#define ETHTOOL_GLANREG     0x00001000  /* Get LAN register */
-#define ETHTOOL_SLANREG     0x00001001  /* Set LAN register */
+/* Netlink helpers */
 
-int find_lan8651_interface(char *ifname, size_t ifname_size) {
-    FILE *fp;
-    char line[256];
-    
-    DEBUG_ENTER();
-    DEBUG_PRINT("Looking for LAN8651 interface in /proc/net/dev");
-    
-    fp = fopen("/proc/net/dev", "r");
-    if (!fp) {
-        DEBUG_PRINT("Failed to open /proc/net/dev: %s", strerror(errno));
-        perror("Cannot open /proc/net/dev");
-        DEBUG_EXIT(-1);
-        return -1;
+static int nl_open(struct nl_sock *sock, int protocol) {
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK };
+
+    sock->fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, protocol);
+    if (sock->fd < 0) {
+        DEBUG_PRINT("Netlink socket creation failed: %s", strerror(errno));
+        return -errno;
     }
-    
-    DEBUG_PRINT("Successfully opened /proc/net/dev");
-    
-    // Skip header lines
-    fgets(line, sizeof(line), fp);
-    fgets(line, sizeof(line), fp);
-    DEBUG_PRINT("Skipped header lines");
-    
-    while (fgets(line, sizeof(line), fp)) {
-        char *iface = strtok(line, ":");
-        DEBUG_PRINT("Processing interface: %s", iface ? iface : "NULL");
-        
-        if (iface && strstr(iface, "eth")) {
-            // Check if this interface uses lan865x driver
-            char driver_path[512];
-            char driver_name[64] = {0};
-            FILE *driver_fp;
-            
-            snprintf(driver_path, sizeof(driver_path), 
-                    "/sys/class/net/%s/device/driver/module", 
-                    iface + (iface[0] == ' ' ? 1 : 0));
-            
-            DEBUG_PRINT("Checking driver path: %s", driver_path);
-            
-            ssize_t len = readlink(driver_path, driver_name, sizeof(driver_name)-1);
-            if (len > 0) {
-                driver_name[len] = '\0';
-                DEBUG_PRINT("Driver link target: %s", driver_name);
-                
-                if (strstr(driver_name, "lan865x")) {
-                    DEBUG_PRINT("Found LAN865x driver for interface: %s", iface);
-                    strncpy(ifname, iface + (iface[0] == ' ' ? 1 : 0), ifname_size);
-                    fclose(fp);
-                    DEBUG_EXIT(0);
-                    return 0;
-                }
-            } else {
-                DEBUG_PRINT("readlink failed for %s: %s", driver_path, strerror(errno));
+
+    if (bind(sock->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = -errno;
+        DEBUG_PRINT("Netlink bind failed: %s", strerror(errno));
+        close(sock->fd);
+        return err;
+    }
+
+    sock->seq = time(NULL);
+    DEBUG_PRINT("Netlink socket opened: protocol=%d, fd=%d", protocol, sock->fd);
+    return 0;
+}
+
+static void nl_close(struct nl_sock *sock) {
+    close(sock->fd);
+}
+
+static void nl_msg_init(struct nl_msg *msg, __u16 type, __u16 flags) {
+    memset(&msg->nlh, 0, sizeof(msg->nlh));
+    msg->nlh.nlmsg_len = NLMSG_HDRLEN;
+    msg->nlh.nlmsg_type = type;
+    msg->nlh.nlmsg_flags = NLM_F_REQUEST | flags;
+}
+
+static void *nl_msg_put(struct nl_msg *msg, size_t len) {
+    void *data = msg->buf + NLMSG_ALIGN(msg->nlh.nlmsg_len);
+
+    if (NLMSG_ALIGN(msg->nlh.nlmsg_len) + NLMSG_ALIGN(len) > sizeof(msg->buf))
+        return NULL;
+
+    memset(data, 0, NLMSG_ALIGN(len));
+    msg->nlh.nlmsg_len = NLMSG_ALIGN(msg->nlh.nlmsg_len) + len;
+    return data;
+}
+
+static struct nlattr *nl_attr_put(struct nl_msg *msg, __u16 type,
+                                  const void *data, size_t len) {
+    struct nlattr *nla = nl_msg_put(msg, NLA_HDRLEN + len);
+
+    if (!nla)
+        return NULL;
+
+    nla->nla_type = type;
+    nla->nla_len = NLA_HDRLEN + len;
+    if (len)
+        memcpy((char *)nla + NLA_HDRLEN, data, len);
+    return nla;
+}
+
+static int nl_attr_put_u32(struct nl_msg *msg, __u16 type, __u32 value) {
+    return nl_attr_put(msg, type, &value, sizeof(value)) ? 0 : -EMSGSIZE;
+}
+
+static struct nlattr *nl_nest_start(struct nl_msg *msg, __u16 type) {
+    return nl_attr_put(msg, type | NLA_F_NESTED, NULL, 0);
+}
+
+static void nl_nest_end(struct nl_msg *msg, struct nlattr *nest) {
+    nest->nla_len = msg->buf + msg->nlh.nlmsg_len - (char *)nest;
+}
+
+#define nl_attr_for_each(nla, head, len) \
+    for (nla = (struct nlattr *)(head); \
+         (len) >= (int)NLA_HDRLEN && nla->nla_len >= NLA_HDRLEN && \
+         nla->nla_len <= (len); \
+         (len) -= NLA_ALIGN(nla->nla_len), \
+         nla = (struct nlattr *)((char *)nla + NLA_ALIGN(nla->nla_len)))
+
+#define nl_attr_data(nla) ((void *)((char *)(nla) + NLA_HDRLEN))
+#define nl_attr_len(nla) ((int)(nla)->nla_len - NLA_HDRLEN)
+#define nl_attr_type(nla) ((nla)->nla_type & NLA_TYPE_MASK)
+
+typedef int (*nl_reply_cb)(struct nlmsghdr *nlh, void *arg);
+
+/*
+ * Send one request and process replies until the ack (or NLMSG_DONE for
+ * dumps). Returns 0 or a negative errno reported by the kernel.
+ */
+static int nl_transact(struct nl_sock *sock, struct nl_msg *msg,
+                       nl_reply_cb cb, void *arg) {
+    static char buf[NL_BUF_SIZE];
+    __u32 seq = ++sock->seq;
+
+    msg->nlh.nlmsg_seq = seq;
+    msg->nlh.nlmsg_flags |= NLM_F_ACK;
+    DEBUG_PRINT("Sending netlink message: type=%u, len=%u, seq=%u",
+                msg->nlh.nlmsg_type, msg->nlh.nlmsg_len, seq);
+    DEBUG_HEX_DUMP(msg->buf, msg->nlh.nlmsg_len);
+
+    if (send(sock->fd, msg->buf, msg->nlh.nlmsg_len, 0) < 0) {
+        DEBUG_PRINT("Netlink send failed: %s", strerror(errno));
+        return -errno;
+    }
+
+    for (;;) {
+        ssize_t len = recv(sock->fd, buf, sizeof(buf), 0);
+        struct nlmsghdr *nlh;
+
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            DEBUG_PRINT("Netlink recv failed: %s", strerror(errno));
+            return -errno;
+        }
+
+        for (nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_seq != seq)
+                continue;
+
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return 0;
+
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                struct nlmsgerr *err = NLMSG_DATA(nlh);
+                DEBUG_PRINT("Netlink ack: error=%d", err->error);
+                /* A dump is ended by NLMSG_DONE, its ack carries no error */
+                if (err->error || !(msg->nlh.nlmsg_flags & NLM_F_DUMP))
+                    return err->error;
+                continue;
+            }
+
+            if (cb) {
+                int ret = cb(nlh, arg);
+                if (ret)
+                    return ret;
             }
         }
     }
-    
-    fclose(fp);
-    return -1;
 }
 
-int lan8651_read_register(const char *ifname, u_int32_t address, u_int32_t *value) {
-    int sock;
-    struct ifreq ifr;
-    struct ethtool_drvinfo drvinfo;
-    struct lan8651_reg_access reg_access;
-    
-    DEBUG_ENTER();
-    DEBUG_PRINT("Interface: %s, Address: 0x%08X", ifname, address);
-    
-    sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0) {
-        DEBUG_PRINT("Socket creation failed: %s", strerror(errno));
-        perror("socket");
-        DEBUG_EXIT(-1);
-        return -1;
+/* Generic netlink family resolution */
+
+static int genl_family_cb(struct nlmsghdr *nlh, void *arg) {
+    struct nlattr *nla;
+    int len = nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+
+    nl_attr_for_each(nla, (char *)NLMSG_DATA(nlh) + GENL_HDRLEN, len) {
+        if (nl_attr_type(nla) == CTRL_ATTR_FAMILY_ID)
+            *(__u16 *)arg = *(__u16 *)nl_attr_data(nla);
     }
-    DEBUG_PRINT("Socket created successfully: fd=%d", sock);
-    
-    memset(&ifr, 0, sizeof(ifr));
-    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
-    DEBUG_PRINT("Prepared ifreq for interface: %s", ifr.ifr_name);
-    
-    // First check if this is really a lan865x interface
-    memset(&drvinfo, 0, sizeof(drvinfo));
-    drvinfo.cmd = ETHTOOL_GDRVINFO;
-    ifr.ifr_data = (char *)&drvinfo;
-    
-    DEBUG_PRINT("Calling ETHTOOL_GDRVINFO ioctl");
-    if (ioctl(sock, SIOCETHTOOL, &ifr) < 0) {
-        DEBUG_PRINT("ETHTOOL_GDRVINFO ioctl failed: %s", strerror(errno));
-        perror("ETHTOOL_GDRVINFO ioctl");
-        close(sock);
-        DEBUG_EXIT(-1);
-        return -1;
+    return 0;
+}
+
+static int genl_resolve_family(struct nl_sock *sock, const char *name,
+                               __u16 *family) {
+    static struct nl_msg msg;
+    struct genlmsghdr *genl;
+    int ret;
+
+    nl_msg_init(&msg, GENL_ID_CTRL, 0);
+    genl = nl_msg_put(&msg, GENL_HDRLEN);
+    genl->cmd = CTRL_CMD_GETFAMILY;
+    genl->version = 1;
+    nl_attr_put(&msg, CTRL_ATTR_FAMILY_NAME, name, strlen(name) + 1);
+
+    *family = 0;
+    ret = nl_transact(sock, &msg, genl_family_cb, family);
+    if (!ret && !*family)
+        ret = -ENOENT;
+    DEBUG_PRINT("Family '%s' resolved to id %u (ret=%d)", name, *family, ret);
+    return ret;
+}
+
+/* Interface enumeration over rtnetlink */
+
+/* Grown as the dump goes, hosts may have any number of veth/bridge ports */
+struct link_list {
+    struct lan8651_iface *links;
+    int count;
+    int size;
+};
+
+static void link_list_free(struct link_list *list) {
+    free(list->links);
+    list->links = NULL;
+    list->count = list->size = 0;
+}
+
+static int rtnl_link_cb(struct nlmsghdr *nlh, void *arg) {
+    struct link_list *list = arg;
+    struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+    struct nlattr *nla;
+    int len = nlh->nlmsg_len - NLMSG_LENGTH(sizeof(*ifi));
+
+    if (nlh->nlmsg_type != RTM_NEWLINK)
+        return 0;
+
+    if (list->count == list->size) {
+        int size = list->size ? 2 * list->size : LINK_LIST_MIN;
+        struct lan8651_iface *links = realloc(list->links, size * sizeof(*links));
+
+        if (!links)
+            return -ENOMEM;
+        list->links = links;
+        list->size = size;
     }
-    
-    DEBUG_PRINT("Driver info: driver='%s', version='%s', fw_version='%s'", 
-                drvinfo.driver, drvinfo.version, drvinfo.fw_version);
-    
-    if (strcmp(drvinfo.driver, "lan865x") != 0) {
-        DEBUG_PRINT("Driver mismatch: expected 'lan865x', got '%s'", drvinfo.driver);
-        fprintf(stderr, "Interface %s is not using lan865x driver\n", ifname);
-        close(sock);
-        DEBUG_EXIT(-1);
-        return -1;
+
+    nl_attr_for_each(nla, (char *)ifi + NLMSG_ALIGN(sizeof(*ifi)), len) {
+        if (nl_attr_type(nla) == IFLA_IFNAME) {
+            struct lan8651_iface *iface = &list->links[list->count++];
+            iface->ifindex = ifi->ifi_index;
+            snprintf(iface->name, sizeof(iface->name), "%s",
+                     (char *)nl_attr_data(nla));
+            DEBUG_PRINT("Link %d: %s", iface->ifindex, iface->name);
+            break;
+        }
     }
-    DEBUG_PRINT("Driver verification successful");
-    
-    // Now try to read register (this would need driver support)
-    memset(&reg_access, 0, sizeof(reg_access));
-    reg_access.cmd = ETHTOOL_GLANREG;
-    reg_access.address = address;
-    reg_access.value = 0;
-    
-    DEBUG_PRINT("Preparing register access: cmd=0x%08X, address=0x%08X", 
-                reg_access.cmd, reg_access.address);
-    
-    ifr.ifr_data = (char *)&reg_access;
-    DEBUG_HEX_DUMP(&reg_access, sizeof(reg_access));
-    
-    DEBUG_PRINT("Calling ETHTOOL_GLANREG ioctl");
-    if (ioctl(sock, SIOCETHTOOL, &ifr) < 0) {
-        DEBUG_PRINT("Register read ioctl failed: %s (errno=%d)", strerror(errno), errno);
-        DEBUG_PRINT("This is expected - driver extension needed for register access");
-        perror("Register read ioctl - driver extension needed");
-        close(sock);
-        DEBUG_EXIT(-1);
-        return -1;
+    return 0;
+}
+
+static int rtnl_list_links(struct link_list *list) {
+    static struct nl_msg msg;
+    struct nl_sock sock;
+    struct ifinfomsg *ifi;
+    int ret;
+
+    DEBUG_ENTER();
+    ret = nl_open(&sock, NETLINK_ROUTE);
+    if (ret)
+        return ret;
+
+    nl_msg_init(&msg, RTM_GETLINK, NLM_F_DUMP);
+    ifi = nl_msg_put(&msg, sizeof(*ifi));
+    ifi->ifi_family = AF_UNSPEC;
+
+    *list = (struct link_list){ 0 };
+    ret = nl_transact(&sock, &msg, rtnl_link_cb, list);
+    nl_close(&sock);
+    if (ret)
+        link_list_free(list);
+    DEBUG_EXIT(ret);
+    return ret;
+}
+
+/* Register access */
+
+struct lan8651_ctx {
+    struct nl_sock sock;
+    __u16 family;
+    int ifindex;
+    char ifname[IFNAMSIZ];
+};
+
+struct read_reply {
+    struct lan8651_block *blocks;
+    int nblocks;
+    int filled;
+};
+
+static int read_reply_cb(struct nlmsghdr *nlh, void *arg) {
+    struct read_reply *reply = arg;
+    struct nlattr *nla, *reg;
+    int len = nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+
+    nl_attr_for_each(nla, (char *)NLMSG_DATA(nlh) + GENL_HDRLEN, len) {
+        struct lan8651_block *block;
+        int reg_len = nl_attr_len(nla);
+
+        if (nl_attr_type(nla) != LAN865X_ATTR_REG)
+            continue;
+        if (reply->filled >= reply->nblocks)
+            return -EPROTO;
+
+        /* Replies come back in request order */
+        block = &reply->blocks[reply->filled++];
+        nl_attr_for_each(reg, nl_attr_data(nla), reg_len) {
+            if (nl_attr_type(reg) != LAN865X_REG_ATTR_VALUES)
+                continue;
+            if (nl_attr_len(reg) != (int)(block->count * sizeof(__u32)))
+                return -EPROTO;
+            memcpy(block->values, nl_attr_data(reg), nl_attr_len(reg));
+        }
     }
-    
-    DEBUG_PRINT("Register read successful: value=0x%08X", reg_access.value);
-    *value = reg_access.value;
-    close(sock);
-    DEBUG_EXIT(0);
     return 0;
 }
 
-int lan8651_write_register(const char *ifname, u_int32_t address, u_int32_t value) {
-    int sock;
-    struct ifreq ifr;
-    struct lan8651_reg_access reg_access;
-    
+static int lan8651_request(struct lan8651_ctx *ctx, __u8 cmd,
+                           struct lan8651_block *blocks, int nblocks,
+                           nl_reply_cb cb, void *arg) {
+    static struct nl_msg msg;
+    struct genlmsghdr *genl;
+
+    nl_msg_init(&msg, ctx->family, 0);
+    genl = nl_msg_put(&msg, GENL_HDRLEN);
+    genl->cmd = cmd;
+    genl->version = LAN865X_GENL_VERSION;
+    nl_attr_put_u32(&msg, LAN865X_ATTR_IFINDEX, ctx->ifindex);
+
+    for (int i = 0; i < nblocks; i++) {
+        struct nlattr *nest = nl_nest_start(&msg, LAN865X_ATTR_REG);
+
+        if (!nest || nl_attr_put_u32(&msg, LAN865X_REG_ATTR_ADDR, blocks[i].address))
+            return -EMSGSIZE;
+
+        if (cmd == LAN865X_CMD_REG_READ) {
+            if (nl_attr_put_u32(&msg, LAN865X_REG_ATTR_COUNT, blocks[i].count))
+                return -EMSGSIZE;
+        } else if (!nl_attr_put(&msg, LAN865X_REG_ATTR_VALUES, blocks[i].values,
+                                blocks[i].count * sizeof(__u32))) {
+            return -EMSGSIZE;
+        }
+        nl_nest_end(&msg, nest);
+    }
+
+    return nl_transact(&ctx->sock, &msg, cb, arg);
+}
+
+/* Read all blocks in a single netlink round trip */
+int lan8651_read_registers(struct lan8651_ctx *ctx, struct lan8651_block *blocks,
+                           int nblocks) {
+    struct read_reply reply = { .blocks = blocks, .nblocks = nblocks };
+    int ret;
+
+    DEBUG_ENTER();
+    ret = lan8651_request(ctx, LAN865X_CMD_REG_READ, blocks, nblocks,
+                          read_reply_cb, &reply);
+    if (!ret && reply.filled != nblocks)
+        ret = -EPROTO;
+    DEBUG_EXIT(ret);
+    return ret;
+}
+
+/* Write all blocks in a single netlink round trip */
+int lan8651_write_registers(struct lan8651_ctx *ctx, struct lan8651_block *blocks,
+                            int nblocks) {
+    int ret;
+
     DEBUG_ENTER();
-    DEBUG_PRINT("Interface: %s, Address: 0x%08X, Value: 0x%08X", ifname, address, value);
-    
-    sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0) {
-        DEBUG_PRINT("Socket creation failed: %s", strerror(errno));
-        perror("socket");
-        DEBUG_EXIT(-1);
-        return -1;
+    ret = lan8651_request(ctx, LAN865X_CMD_REG_WRITE, blocks, nblocks, NULL, NULL);
+    DEBUG_EXIT(ret);
+    return ret;
+}
+
+/*
+ * Find a LAN865x interface: the driver only answers register requests
+ * for its own devices, so probe each link with a read of OA_ID.
+ */
+int find_lan8651_interface(struct lan8651_ctx *ctx, const char *wanted) {
+    struct link_list list;
+    __u32 oa_id;
+    struct lan8651_block probe = { .address = 0x0000, .count = 1, .values = &oa_id };
+    int ret;
+
+    DEBUG_ENTER();
+    ret = rtnl_list_links(&list);
+    if (ret) {
+        fprintf(stderr, "Cannot list network interfaces: %s\n", strerror(-ret));
+        return ret;
     }
-    DEBUG_PRINT("Socket created successfully: fd=%d", sock);
-    
-    memset(&ifr, 0, sizeof(ifr));
-    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
-    DEBUG_PRINT("Prepared ifreq for interface: %s", ifr.ifr_name);
-    
-    memset(&reg_access, 0, sizeof(reg_access));
-    reg_access.cmd = ETHTOOL_SLANREG;
-    reg_access.address = address;
-    reg_access.value = value;
-    
-    DEBUG_PRINT("Preparing register write: cmd=0x%08X, address=0x%08X, value=0x%08X", 
-                reg_access.cmd, reg_access.address, reg_access.value);
-    
-    ifr.ifr_data = (char *)&reg_access;
-    DEBUG_HEX_DUMP(&reg_access, sizeof(reg_access));
-    
-    DEBUG_PRINT("Calling ETHTOOL_SLANREG ioctl");
-    if (ioctl(sock, SIOCETHTOOL, &ifr) < 0) {
-        DEBUG_PRINT("Register write ioctl failed: %s (errno=%d)", strerror(errno), errno);
-        DEBUG_PRINT("This is expected - driver extension needed for register access");
-        perror("Register write ioctl - driver extension needed");
-        close(sock);
-        DEBUG_EXIT(-1);
-        return -1;
+
+    for (int i = 0; i < list.count; i++) {
+        if (wanted && strcmp(wanted, list.links[i].name))
+            continue;
+
+        ctx->ifindex = list.links[i].ifindex;
+        ret = lan8651_read_registers(ctx, &probe, 1);
+        DEBUG_PRINT("Probe of %s: ret=%d", list.links[i].name, ret);
+        if (!ret) {
+            snprintf(ctx->ifname, sizeof(ctx->ifname), "%s", list.links[i].name);
+            link_list_free(&list);
+            DEBUG_EXIT(0);
+            return 0;
+        }
+        if (wanted) {
+            fprintf(stderr, "Interface %s: %s\n", wanted, strerror(-ret));
+            link_list_free(&list);
+            return ret;
+        }
     }
-    
-    DEBUG_PRINT("Register write successful");
-    close(sock);
-    DEBUG_EXIT(0);
-    return 0;
+
+    link_list_free(&list);
+    DEBUG_EXIT(-ENODEV);
+    return -ENODEV;
+}
+
+static int list_interfaces(struct lan8651_ctx *ctx) {
+    struct link_list list;
+    __u32 oa_id;
+    struct lan8651_block probe = { .address = 0x0000, .count = 1, .values = &oa_id };
+    int found = 0;
+    int ret;
+
+    ret = rtnl_list_links(&list);
+    if (ret) {
+        fprintf(stderr, "Cannot list network interfaces: %s\n", strerror(-ret));
+        return 1;
+    }
+
+    for (int i = 0; i < list.count; i++) {
+        ctx->ifindex = list.links[i].ifindex;
+        if (!lan8651_read_registers(ctx, &probe, 1)) {
+            printf("%s (ifindex %d): OA_ID = 0x%08X\n", list.links[i].name,
+                   list.links[i].ifindex, oa_id);
+            found++;
+        }
+    }
+    link_list_free(&list);
+
+    if (!found)
+        printf("No LAN8651 interface found\n");
+    return found ? 0 : 1;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-i <ifname>] <command> [args]\n", prog);
+    printf("Commands:\n");
+    printf("  read <address>[:count] [...]      - Read registers, all in one request\n");
+    printf("  write <address> <value> [...]     - Write consecutive registers\n");
+    printf("  list                              - List LAN8651 interfaces\n");
+    printf("Example: %s read 0x10000\n", prog);
+    printf("Example: %s read 0x0008:4 0x10000:2\n", prog);
+    printf("Example: %s write 0x10000 0x0C\n", prog);
+    printf("\nNote: Compile with -DDEBUG_ENABLED=1 to enable debug output\n");
 }
 
 int main(int argc, char *argv[]) {
-    char ifname[IFNAMSIZ];
-    u_int32_t address, value;
+    static __u32 values[LAN865X_NL_MAX_MSG_REGS];
+    struct lan8651_block blocks[MAX_BLOCKS];
+    struct lan8651_ctx ctx = { 0 };
+    const char *ifname = NULL;
+    int nblocks = 0;
+    int used = 0;
     int ret;
-    
-    DEBUG_PRINT("=== LAN8651 ETHTOOL REGISTER ACCESS TOOL ===");
+
+    DEBUG_PRINT("=== LAN8651 NETLINK REGISTER ACCESS TOOL ===");
     DEBUG_PRINT("Debug output is %s", DEBUG_ENABLED ? "ENABLED" : "DISABLED");
     DEBUG_PRINT("Arguments: argc=%d", argc);
     for (int i = 0; i < argc; i++) {
         DEBUG_PRINT("  argv[%d] = '%s'", i, argv[i]);
     }
-    
+
+    if (argc >= 3 && strcmp(argv[1], "-i") == 0) {
+        ifname = argv[2];
+        argv += 2;
+        argc -= 2;
+    }
+
     if (argc < 2) {
-        printf("Usage: %s <read|write> [address] [value]\n", argv[0]);
-        printf("Example: %s read 0x10000\n", argv[0]);
-        printf("Example: %s write 0x10000 0x0C\n", argv[0]);
-        printf("\nNote: Compile with -DDEBUG_ENABLED=1 to enable debug output\n");
+        usage(argv[0]);
+        return 1;
+    }
+
+    ret = nl_open(&ctx.sock, NETLINK_GENERIC);
+    if (ret) {
+        fprintf(stderr, "Cannot open generic netlink socket: %s\n", strerror(-ret));
+        return 1;
+    }
+
+    ret = genl_resolve_family(&ctx.sock, LAN865X_GENL_NAME, &ctx.family);
+    if (ret) {
+        fprintf(stderr, "lan865x netlink family not available (driver loaded?): %s\n",
+                strerror(-ret));
+        nl_close(&ctx.sock);
         return 1;
     }
-    
+
+    if (strcmp(argv[1], "list") == 0) {
+        ret = list_interfaces(&ctx);
+        nl_close(&ctx.sock);
+        return ret;
+    }
+
     // Find LAN8651 interface
-    if (find_lan8651_interface(ifname, sizeof(ifname)) < 0) {
+    if (find_lan8651_interface(&ctx, ifname) < 0) {
         fprintf(stderr, "No LAN8651 interface found\n");
+        nl_close(&ctx.sock);
         return 1;
     }
-    
-    printf("Using interface: %s\n", ifname);
-    
+
+    printf("Using interface: %s\n", ctx.ifname);
+
     if (strcmp(argv[1], "read") == 0) {
-        if (argc != 3) {
-            printf("Usage: %s read <address>\n", argv[0]);
-            return 1;
+        if (argc < 3) {
+            printf("Usage: %s read <address>[:count] [...]\n", argv[0]);
+            ret = 1;
+            goto out;
+        }
+
+        for (int i = 2; i < argc; i++) {
+            char *end;
+            struct lan8651_block *block = &blocks[nblocks];
+
+            if (nblocks >= MAX_BLOCKS) {
+                fprintf(stderr, "Too many register blocks (max %d)\n", MAX_BLOCKS);
+                ret = 1;
+                goto out;
+            }
+
+            block->address = strtoul(argv[i], &end, 0);
+            block->count = *end == ':' ? strtoul(end + 1, NULL, 0) : 1;
+            if (!block->count || block->count > LAN865X_NL_MAX_BLOCK_REGS ||
+                used + block->count > LAN865X_NL_MAX_MSG_REGS) {
+                fprintf(stderr, "Invalid register count in '%s'\n", argv[i]);
+                ret = 1;
+                goto out;
+            }
+            block->values = &values[used];
+            used += block->count;
+            nblocks++;
         }
-        
-        address = strtoul(argv[2], NULL, 0);
-        ret = lan8651_read_register(ifname, address, &value);
+
+        ret = lan8651_read_registers(&ctx, blocks, nblocks);
         if (ret == 0) {
-            printf("READ 0x%08X = 0x%08X (%u)\n", address, value, value);
+            for (int b = 0; b < nblocks; b++) {
+                for (__u32 i = 0; i < blocks[b].count; i++) {
+                    printf("READ 0x%08X = 0x%08X (%u)\n", blocks[b].address + i,
+                           blocks[b].values[i], blocks[b].values[i]);
+                }
+            }
         } else {
-            printf("ERROR: Read failed\n");
+            printf("ERROR: Read failed: %s\n", strerror(-ret));
         }
     }
     else if (strcmp(argv[1], "write") == 0) {
-        if (argc != 4) {
-            printf("Usage: %s write <address> <value>\n", argv[0]);
-            return 1;
+        if (argc < 4 || argc - 3 > LAN865X_NL_MAX_BLOCK_REGS) {
+            printf("Usage: %s write <address> <value> [value ...]\n", argv[0]);
+            ret = 1;
+            goto out;
         }
-        
-        address = strtoul(argv[2], NULL, 0);
-        value = strtoul(argv[3], NULL, 0);
-        ret = lan8651_write_register(ifname, address, value);
+
+        blocks[0].address = strtoul(argv[2], NULL, 0);
+        blocks[0].count = argc - 3;
+        blocks[0].values = values;
+        for (int i = 3; i < argc; i++)
+            values[i - 3] = strtoul(argv[i], NULL, 0);
+
+        ret = lan8651_write_registers(&ctx, blocks, 1);
         if (ret == 0) {
-            printf("WRITE 0x%08X = 0x%08X - OK\n", address, value);
+            for (__u32 i = 0; i < blocks[0].count; i++)
+                printf("WRITE 0x%08X = 0x%08X - OK\n", blocks[0].address + i, values[i]);
         } else {
-            printf("ERROR: Write failed\n");
+            printf("ERROR: Write failed: %s\n", strerror(-ret));
         }
     }
     else {
         printf("Unknown command: %s\n", argv[1]);
-        return 1;
+        ret = 1;
     }
-    
-    return ret;
-}
\ No newline at end of file
+
+out:
+    nl_close(&ctx.sock);
+    return ret ? 1 : 0;
+}
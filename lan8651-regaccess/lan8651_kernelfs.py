@@ -7,7 +7,10 @@ creating a custom kernel module.
 """
 
 import os
+import re
 import glob
+import socket
+import json
 import struct
 import subprocess
 import sys
@@ -63,8 +66,15 @@ LAN8651_REGISTERS = {
     'STATS0': 0x10208,         # Statistics 0
     'STATS1': 0x10209,         # Statistics 1
     'STATS2': 0x1020A,         # Statistics 2
+    'STATS6': 0x1020E,         # Total Frames RX
+    'STATS7': 0x1020F,         # Frames RX
+    'STATS11': 0x10213,        # Total Frames TX
+    'STATS12': 0x10214,        # Frames TX
 }
 
+# BMGR_CTL: latch the MAC statistics counters into the STATS registers
+LAN8651_BMGR_CTL_SNAPSTATS = (1 << 5)
+
 # Register bit definitions
 LAN8651_STATUS0_BITS = {
     'PHYINT': (1 << 7),        # PHY Interrupt
@@ -139,41 +149,203 @@ def parse_register_address(addr_str):
     except ValueError:
         raise ValueError(f"Invalid register address: {addr_str}")
 
+LAN8651_MAC_NCR_BITS = {
+    'TXEN': (1 << 3),          # Transmit Enable
+    'RXEN': (1 << 2),          # Receive Enable
+}
+
+LAN8651_MAC_NCFGR_BITS = {
+    'UNICAST_HASH': (1 << 7),  # Unicast Hash Enable
+    'MULTICAST_HASH': (1 << 6),# Multicast Hash Enable
+    'PROMISCUOUS': (1 << 4),   # Copy All Frames
+}
+
+# Named bits per register address, with the label used when decoding
+REGISTER_BIT_TABLES = {
+    LAN8651_REGISTERS['OA_STATUS0']: ('Status bits', LAN8651_STATUS0_BITS),
+    LAN8651_REGISTERS['BASIC_CONTROL']: ('Control bits', LAN8651_BASIC_CONTROL_BITS),
+    LAN8651_REGISTERS['BASIC_STATUS']: ('Status bits', LAN8651_BASIC_STATUS_BITS),
+    LAN8651_REGISTERS['MAC_NCR']: ('Control bits', LAN8651_MAC_NCR_BITS),
+    LAN8651_REGISTERS['MAC_NCFGR']: ('Config bits', LAN8651_MAC_NCFGR_BITS),
+}
+
 def decode_register_bits(addr, value):
     """Decode register bits for known registers"""
-    if addr == LAN8651_REGISTERS['OA_STATUS0']:
-        bits = []
-        for name, bit_val in LAN8651_STATUS0_BITS.items():
-            if value & bit_val:
-                bits.append(name)
-        return f"Status bits: {', '.join(bits) if bits else 'none'}"
-    
-    elif addr == LAN8651_REGISTERS['BASIC_CONTROL']:
-        bits = []
-        for name, bit_val in LAN8651_BASIC_CONTROL_BITS.items():
-            if value & bit_val:
-                bits.append(name)
-        return f"Control bits: {', '.join(bits) if bits else 'none'}"
-    
-    elif addr == LAN8651_REGISTERS['BASIC_STATUS']:
-        bits = []
-        for name, bit_val in LAN8651_BASIC_STATUS_BITS.items():
-            if value & bit_val:
-                bits.append(name)
-        return f"Status bits: {', '.join(bits) if bits else 'none'}"
-    
+    if addr == LAN8651_REGISTERS['OA_BUFSTS']:
+        return f"TX credits (TXC): {(value >> 8) & 0xFF}, RX blocks (RBA): {value & 0xFF}"
+
+    if addr not in REGISTER_BIT_TABLES:
+        return None
+
+    label, table = REGISTER_BIT_TABLES[addr]
+    bits = [name for name, bit_val in table.items() if value & bit_val]
+    return f"{label}: {', '.join(bits) if bits else 'none'}"
+
+def get_bit_name(addr, bit):
+    """Get the name of a single register bit, if known"""
+    if addr in REGISTER_BIT_TABLES:
+        for name, bit_val in REGISTER_BIT_TABLES[addr][1].items():
+            if bit_val == (1 << bit):
+                return name
     return None
 
+# Generic netlink register access of the lan865x driver (see lan865x_nl.h)
+NETLINK_GENERIC = 16
+NLM_F_REQUEST = 0x01
+NLMSG_ERROR = 0x02
+NLA_F_NESTED = 0x8000
+GENL_ID_CTRL = 0x10
+CTRL_CMD_GETFAMILY = 3
+CTRL_ATTR_FAMILY_ID = 1
+CTRL_ATTR_FAMILY_NAME = 2
+
+LAN865X_GENL_NAME = 'lan865x'
+LAN865X_GENL_VERSION = 1
+LAN865X_CMD_REG_READ = 1
+LAN865X_CMD_REG_WRITE = 2
+LAN865X_ATTR_IFINDEX = 1
+LAN865X_ATTR_REG = 2
+LAN865X_REG_ATTR_ADDR = 1
+LAN865X_REG_ATTR_COUNT = 2
+LAN865X_REG_ATTR_VALUES = 3
+LAN865X_NL_MAX_BLOCK_REGS = 128
+LAN865X_NL_MAX_MSG_REGS = 1024
+
+# spi_driver name of lan865x.c (DRV_NAME), plus the module name
+LAN865X_DRIVER_NAMES = ('lan8650', 'lan865x')
+
+NLMSG_HDR = struct.Struct('=IHHII')
+GENL_HDR = struct.Struct('=BBH')
+NLA_HDR = struct.Struct('=HH')
+
+def nla_pack(attr_type, payload):
+    """Pack one netlink attribute, padded to 4 bytes"""
+    length = NLA_HDR.size + len(payload)
+    return NLA_HDR.pack(length, attr_type) + payload + b'\0' * (-length % 4)
+
+def nla_parse(data):
+    """Yield (type, payload) for the attributes in data"""
+    offset = 0
+    while offset + NLA_HDR.size <= len(data):
+        length, attr_type = NLA_HDR.unpack_from(data, offset)
+        if length < NLA_HDR.size:
+            break
+        yield attr_type & ~NLA_F_NESTED, data[offset + NLA_HDR.size:offset + length]
+        offset += (length + 3) & ~3
+
+class LAN8651Genl:
+    """Batched register reads through the 'lan865x' generic netlink family
+
+    Consecutive registers are read with one OA-TC6 control transaction per
+    block instead of one debugfs round trip per register.
+    """
+
+    def __init__(self, iface):
+        self.ifindex = int(Path(f"/sys/class/net/{iface}/ifindex").read_text())
+        self.sock = socket.socket(socket.AF_NETLINK, socket.SOCK_RAW, NETLINK_GENERIC)
+        self.seq = 0
+        self.family = self.resolve_family()
+
+    def close(self):
+        self.sock.close()
+
+    def request(self, msg_type, cmd, version, attrs):
+        """Send one request and return the attributes of its reply"""
+        self.seq += 1
+        payload = GENL_HDR.pack(cmd, version, 0) + attrs
+        self.sock.send(NLMSG_HDR.pack(NLMSG_HDR.size + len(payload), msg_type,
+                                      NLM_F_REQUEST, self.seq, 0) + payload)
+        while True:
+            data = self.sock.recv(1 << 17)
+            offset = 0
+            while offset + NLMSG_HDR.size <= len(data):
+                length, reply_type, _, seq, _ = NLMSG_HDR.unpack_from(data, offset)
+                body = data[offset + NLMSG_HDR.size:offset + length]
+                offset += (length + 3) & ~3
+                if seq != self.seq:
+                    continue
+                if reply_type == NLMSG_ERROR:
+                    error = struct.unpack_from('=i', body)[0]
+                    raise OSError(-error, os.strerror(-error))
+                return body[GENL_HDR.size:]
+
+    def resolve_family(self):
+        name = nla_pack(CTRL_ATTR_FAMILY_NAME, LAN865X_GENL_NAME.encode() + b'\0')
+        for attr_type, payload in nla_parse(self.request(GENL_ID_CTRL,
+                                                          CTRL_CMD_GETFAMILY,
+                                                          1, name)):
+            if attr_type == CTRL_ATTR_FAMILY_ID:
+                return struct.unpack_from('=H', payload)[0]
+        raise OSError(f"{LAN865X_GENL_NAME} family has no id")
+
+    def read_registers(self, addresses):
+        """Read addresses as blocks of consecutive registers"""
+        blocks = []
+        for address in sorted(set(addresses)):
+            if (blocks and address == blocks[-1][0] + blocks[-1][1] and
+                    blocks[-1][1] < LAN865X_NL_MAX_BLOCK_REGS):
+                blocks[-1][1] += 1
+            else:
+                blocks.append([address, 1])
+
+        values = {}
+        while blocks:
+            attrs = nla_pack(LAN865X_ATTR_IFINDEX, struct.pack('=I', self.ifindex))
+            total = 0
+            while blocks and total + blocks[0][1] <= LAN865X_NL_MAX_MSG_REGS:
+                address, count = blocks.pop(0)
+                total += count
+                attrs += nla_pack(LAN865X_ATTR_REG | NLA_F_NESTED,
+                                  nla_pack(LAN865X_REG_ATTR_ADDR, struct.pack('=I', address)) +
+                                  nla_pack(LAN865X_REG_ATTR_COUNT, struct.pack('=I', count)))
+            reply = self.request(self.family, LAN865X_CMD_REG_READ,
+                                 LAN865X_GENL_VERSION, attrs)
+            for attr_type, payload in nla_parse(reply):
+                if attr_type != LAN865X_ATTR_REG:
+                    continue
+                reg = dict(nla_parse(payload))
+                address = struct.unpack('=I', reg[LAN865X_REG_ATTR_ADDR])[0]
+                data = reg[LAN865X_REG_ATTR_VALUES]
+                for i, value in enumerate(struct.unpack(f"={len(data) // 4}I", data)):
+                    values[address + i] = value
+        return values
+
+    def write_registers(self, address, values):
+        """Write values to consecutive registers starting at address"""
+        block = (nla_pack(LAN865X_REG_ATTR_ADDR, struct.pack('=I', address)) +
+                 nla_pack(LAN865X_REG_ATTR_VALUES,
+                          struct.pack(f"={len(values)}I", *values)))
+        attrs = (nla_pack(LAN865X_ATTR_IFINDEX, struct.pack('=I', self.ifindex)) +
+                 nla_pack(LAN865X_ATTR_REG | NLA_F_NESTED, block))
+        self.request(self.family, LAN865X_CMD_REG_WRITE, LAN865X_GENL_VERSION, attrs)
+
 class LAN8651Debugfs:
     def __init__(self):
         debug_print("Initializing LAN8651Debugfs class")
         self.debugfs_path = None
         self.sysfs_path = None
+        self.genl = None
+        self.genl_failed = False
         debug_print("Starting interface detection")
         self.find_interfaces()
         debug_print("Initialization complete: debugfs_path=%s, sysfs_path=%s", 
                    self.debugfs_path, self.sysfs_path)
     
+    def get_genl(self):
+        """Generic netlink socket, opened once and kept for later requests"""
+        if self.genl is None and self.sysfs_path and not self.genl_failed:
+            try:
+                self.genl = LAN8651Genl(self.sysfs_path.split('/')[-2])
+            except OSError as e:
+                debug_print("Generic netlink not available: %s", e)
+                self.genl_failed = True
+        return self.genl
+
+    def close(self):
+        if self.genl:
+            self.genl.close()
+            self.genl = None
+
     def find_interfaces(self):
         """Find LAN8651 network interfaces via sysfs"""
         
@@ -193,7 +365,7 @@ class LAN8651Debugfs:
                 driver_link = os.readlink(device_path)
                 debug_print("Driver link target: %s", driver_link)
                 
-                if "lan865x" in driver_link:
+                if os.path.basename(driver_link) in LAN865X_DRIVER_NAMES:
                     # Found a LAN8651 interface
                     iface_name = device_path.split('/')[-3]
                     debug_print("Found LAN865x driver! Interface: %s", iface_name)
@@ -208,6 +380,7 @@ class LAN8651Debugfs:
                 continue
         else:
             debug_print("No LAN865x interfaces found in sysfs")
+            self.find_interface_genl()
         
         # Look for debugfs entries
         debug_print("Searching for debugfs entries")
@@ -241,6 +414,34 @@ class LAN8651Debugfs:
             debug_print("Debugfs is not mounted at /sys/kernel/debug")
             error_print("Debugfs not available - kernel may need CONFIG_DEBUG_FS=y")
     
+    def find_interface_genl(self):
+        """Probe every netdev with a generic netlink read of OA_ID
+
+        The driver only answers register requests for its own devices, so
+        this also works when the sysfs driver link does not tell.
+        """
+        ifaces = [os.path.basename(os.path.dirname(path)) for path in
+                  sorted(glob.glob("/sys/class/net/*/ifindex"))]
+        if not ifaces:
+            return
+        try:
+            genl = LAN8651Genl(ifaces[0])
+        except OSError as e:
+            debug_print("Generic netlink not available: %s", e)
+            return
+        try:
+            for iface in ifaces:
+                try:
+                    genl.ifindex = int(Path(f"/sys/class/net/{iface}/ifindex").read_text())
+                    genl.read_registers([LAN8651_REGISTERS['OA_ID']])
+                except (OSError, ValueError):
+                    continue
+                self.sysfs_path = f"/sys/class/net/{iface}/device"
+                info_print("Found LAN8651 interface via netlink: %s", iface)
+                return
+        finally:
+            genl.close()
+
     def read_via_debugfs(self, address):
         """Try to read register via debugfs if available"""
         
@@ -338,15 +539,103 @@ class LAN8651Debugfs:
         error_print("All read methods failed for %s - kernel driver extension needed", reg_name)
         return None
         
+    def read_via_debugfs_regs(self, fd, address):
+        """Read register through the driver's debugfs 'regs' file
+
+        Writing an address triggers the read, reading the file back reports
+        it as the last accessed register.
+        """
+        os.write(fd, f"{address:08x}".encode())
+        result = os.pread(fd, 1024, 0).decode(errors='replace')
+        match = re.search(r"Last accessed: addr=0x([0-9a-fA-F]+), val=0x([0-9a-fA-F]+)", result)
+        if match and int(match.group(1), 16) == address:
+            return int(match.group(2), 16)
+        return None
+
+    def read_registers(self, addresses):
+        """Read many registers in one pass with a single backend resolution
+
+        Returns (backend name, {address: value}); registers that could not be
+        read are left out.
+        """
+        if not addresses:
+            return None, {}
+
+        probe = addresses[0]
+
+        # Backend 1: generic netlink, one control transaction per block
+        genl = self.get_genl()
+        if genl:
+            try:
+                return 'genl', genl.read_registers(addresses)
+            except (OSError, KeyError, struct.error) as e:
+                debug_print("Generic netlink read failed: %s", e)
+
+        # Backend 2: driver debugfs 'regs' file, kept open for the whole pass.
+        # Every read-back of the file also reads MAC_NET_CTL, so this costs
+        # two control transactions per register.
+        if self.debugfs_path and os.path.exists(f"{self.debugfs_path}/regs"):
+            try:
+                fd = os.open(f"{self.debugfs_path}/regs", os.O_RDWR)
+            except OSError as e:
+                debug_print("Cannot open debugfs regs: %s", e)
+            else:
+                try:
+                    if self.read_via_debugfs_regs(fd, probe) is not None:
+                        values = {}
+                        for address in addresses:
+                            try:
+                                value = self.read_via_debugfs_regs(fd, address)
+                            except OSError as e:
+                                debug_print("Debugfs read of 0x%08x failed: %s", address, e)
+                                continue
+                            if value is not None:
+                                values[address] = value
+                        return 'debugfs', values
+                except OSError as e:
+                    debug_print("Debugfs probe failed: %s", e)
+                finally:
+                    os.close(fd)
+
+        # Backend 3/4: per-register debugfs 'registers' and SPI debug files
+        for name, method in (('debugfs', self.read_via_debugfs),
+                             ('spi-debug', self.read_via_spi_debug)):
+            if method(probe) is not None:
+                values = {}
+                for address in addresses:
+                    value = method(address)
+                    if value is not None:
+                        values[address] = value
+                return name, values
+
+        error_print("All read methods failed - kernel driver extension needed")
+        return None, {}
+
     def write_register(self, address, value):
         """Try multiple methods to write register"""
         
         reg_name = get_register_name(address)
         debug_print("Attempting to write register %s (0x%08x) = 0x%08x", reg_name, address, value)
         
-        # Similar implementation for write operations
-        # This would need to be implemented based on available kernel interfaces
-        error_print("Write operations not yet implemented for %s", reg_name)
+        # Method 1: generic netlink
+        genl = self.get_genl()
+        if genl:
+            try:
+                genl.write_registers(address, [value])
+                return True
+            except OSError as e:
+                debug_print("Generic netlink write failed: %s", e)
+
+        # Method 2: driver debugfs 'regs' file
+        if self.debugfs_path and os.path.exists(f"{self.debugfs_path}/regs"):
+            try:
+                with open(f"{self.debugfs_path}/regs", 'w') as f:
+                    f.write(f"{address:08x} {value:08x}")
+                return True
+            except OSError as e:
+                debug_print("Debugfs write failed: %s", e)
+
+        error_print("All write methods failed for %s", reg_name)
         return False
 
 def show_register_info(address, value):
@@ -389,6 +678,120 @@ def show_register_info(address, value):
             print(f"TX_CUT_THROUGH: {(value >> 4) & 1}")
             print(f"RX_CUT_THROUGH: {(value >> 5) & 1}")
 
+SNAPSHOT_FORMAT = 'lan8651-snapshot'
+SNAPSHOT_EXCLUDED_REGS = [LAN8651_REGISTERS['MMDCTRL'], LAN8651_REGISTERS['MMDAD']]
+SNAPSHOT_VERSION = 1
+# Binary snapshot: magic, version, register count, timestamp, then
+# (address, value) pairs
+SNAPSHOT_MAGIC = b'L865SNAP'
+SNAPSHOT_HEADER = struct.Struct('<8sHHd')
+SNAPSHOT_ENTRY = struct.Struct('<II')
+
+def take_snapshot(debugfs):
+    """Read the whole register table in one batched pass"""
+    # MMDAD is an indirect MMD access with side effects, and MMDCTRL selects
+    # what it accesses; a snapshot must not change device state.
+    addresses = sorted(set(LAN8651_REGISTERS.values()) -
+                       set(SNAPSHOT_EXCLUDED_REGS))
+    start = time.monotonic()
+    backend, values = debugfs.read_registers(addresses)
+    elapsed = time.monotonic() - start
+    info_print("Read %d/%d registers via %s in %.1f ms",
+               len(values), len(addresses), backend, elapsed * 1000)
+
+    iface = debugfs.sysfs_path.split('/')[-2] if debugfs.sysfs_path else None
+    return {
+        'format': SNAPSHOT_FORMAT,
+        'version': SNAPSHOT_VERSION,
+        'timestamp': time.time(),
+        'interface': iface,
+        'backend': backend,
+        'registers': {get_register_name(a): v for a, v in sorted(values.items())},
+    }
+
+def snapshot_addresses(snapshot):
+    """Map a snapshot's registers to {address: value}"""
+    return {parse_register_address(name): value
+            for name, value in snapshot['registers'].items()}
+
+def save_snapshot(snapshot, path):
+    """Save snapshot as binary (*.bin) or JSON"""
+    if path.endswith('.bin'):
+        values = snapshot_addresses(snapshot)
+        with open(path, 'wb') as f:
+            f.write(SNAPSHOT_HEADER.pack(SNAPSHOT_MAGIC, SNAPSHOT_VERSION,
+                                         len(values), snapshot['timestamp']))
+            for address, value in sorted(values.items()):
+                f.write(SNAPSHOT_ENTRY.pack(address, value))
+    else:
+        # Hex strings keep the file greppable and diffable as text
+        data = dict(snapshot)
+        data['registers'] = {name: f"0x{value:08x}"
+                             for name, value in snapshot['registers'].items()}
+        with open(path, 'w') as f:
+            json.dump(data, f, indent=1)
+
+def load_snapshot(path):
+    """Load a snapshot written by save_snapshot()"""
+    with open(path, 'rb') as f:
+        raw = f.read()
+
+    if raw.startswith(SNAPSHOT_MAGIC):
+        magic, version, count, timestamp = SNAPSHOT_HEADER.unpack_from(raw)
+        if version != SNAPSHOT_VERSION:
+            raise ValueError(f"{path}: unsupported snapshot version {version}")
+        registers = {}
+        for i in range(count):
+            address, value = SNAPSHOT_ENTRY.unpack_from(
+                raw, SNAPSHOT_HEADER.size + i * SNAPSHOT_ENTRY.size)
+            registers[get_register_name(address)] = value
+        return {'format': SNAPSHOT_FORMAT, 'version': version,
+                'timestamp': timestamp, 'interface': None, 'backend': None,
+                'registers': registers}
+
+    data = json.loads(raw)
+    if data.get('format') != SNAPSHOT_FORMAT:
+        raise ValueError(f"{path}: not a LAN8651 register snapshot")
+    data['registers'] = {name: int(value, 0)
+                         for name, value in data['registers'].items()}
+    return data
+
+def diff_snapshots(old, new):
+    """Print registers that differ between two snapshots, bit by bit"""
+    old_values = snapshot_addresses(old)
+    new_values = snapshot_addresses(new)
+    changed = 0
+
+    for address in sorted(set(old_values) | set(new_values)):
+        name = get_register_name(address)
+        a = old_values.get(address)
+        b = new_values.get(address)
+        if a == b:
+            continue
+
+        changed += 1
+        if a is None or b is None:
+            which = 'first' if a is None else 'second'
+            print(f"\n{name} (0x{address:08X}): missing in {which} snapshot")
+            continue
+
+        print(f"\n{name} (0x{address:08X}): 0x{a:08X} -> 0x{b:08X}")
+        diff = a ^ b
+        for bit in range(31, -1, -1):
+            if diff & (1 << bit):
+                bit_name = get_bit_name(address, bit)
+                label = f" ({bit_name})" if bit_name else ""
+                state = "set" if b & (1 << bit) else "cleared"
+                print(f"  bit {bit:2d}{label}: {state}")
+
+        old_desc = decode_register_bits(address, a)
+        if old_desc:
+            print(f"  before: {old_desc}")
+            print(f"  after:  {decode_register_bits(address, b)}")
+
+    print(f"\n{changed} register(s) differ")
+    return changed
+
 def main():
     if len(sys.argv) < 2:
         print("Usage: python3 lan8651_kernelfs.py <command> [args...]")
@@ -397,13 +800,28 @@ def main():
         print("  write <addr> <val> - Write register") 
         print("  list              - List known registers")
         print("  status            - Show device status")
+        print("  snapshot <file>   - Save all registers (*.bin = binary, else JSON)")
+        print("  diff <a> <b>      - Compare two snapshots bit by bit")
         print("\nExamples:")
         print("  python3 lan8651_kernelfs.py read 0x10000")
         print("  python3 lan8651_kernelfs.py read OA_STATUS0")
         print("  python3 lan8651_kernelfs.py write MAC_NCR 0x0C")
         print("  python3 lan8651_kernelfs.py list")
+        print("  python3 lan8651_kernelfs.py snapshot good.json")
+        print("  python3 lan8651_kernelfs.py diff good.json bad.json")
         return
-    
+
+    # Diffing stored snapshots needs no device access
+    if sys.argv[1] == "diff":
+        if len(sys.argv) < 4:
+            print("Error: Two snapshot files required for diff command")
+            return
+        try:
+            diff_snapshots(load_snapshot(sys.argv[2]), load_snapshot(sys.argv[3]))
+        except (OSError, ValueError, KeyError) as e:
+            print(f"Error: {e}")
+        return
+
     debugfs = LAN8651Debugfs()
     
     if sys.argv[1] == "list":
@@ -481,6 +899,18 @@ def main():
                     print(f"\n{description}: Failed to read")
             except KeyError:
                 print(f"\n{description}: Register not defined")
+
+    elif sys.argv[1] == "snapshot":
+        if len(sys.argv) < 3:
+            print("Error: Output file required for snapshot command")
+            return
+
+        snapshot = take_snapshot(debugfs)
+        if not snapshot['registers']:
+            print("Failed to read registers")
+            return
+        save_snapshot(snapshot, sys.argv[2])
+        print(f"Saved {len(snapshot['registers'])} registers to {sys.argv[2]}")
     else:
         print(f"Error: Unknown command '{sys.argv[1]}'")
         print("Use 'python3 lan8651_kernelfs.py' for usage help")
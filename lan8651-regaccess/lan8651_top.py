@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+"""
+LAN8651 live monitor - "top" for a running LAN865x device
+
+Shows frame and error rates, sampled OA_STATUS0/STATUS1 error bits, buffer
+occupancy from OA_BUFSTS and link state. Every refresh is one batched
+register snapshot; the SPI overhead this costs is configurable and shown.
+"""
+
+import os
+import sys
+import time
+import curses
+import argparse
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from lan8651_kernelfs import (LAN8651Debugfs, LAN8651_REGISTERS,
+                              LAN8651_STATUS0_BITS, LAN8651_BASIC_STATUS_BITS,
+                              LAN8651_BMGR_CTL_SNAPSTATS,
+                              parse_register_address, get_register_name)
+
+# Registers read on every refresh unless overridden with --regs
+DEFAULT_MONITOR_REGS = [
+    'OA_STATUS0', 'OA_STATUS1', 'OA_BUFSTS', 'BASIC_STATUS', 'MAC_NCR',
+    'STATS6', 'STATS7', 'STATS11', 'STATS12', 'STATS0', 'STATS1', 'STATS2',
+]
+# MAC frame counters as (label, frames, total frames)
+FRAME_STATS = [('TX', 'STATS12', 'STATS11'), ('RX', 'STATS7', 'STATS6')]
+# MAC error counters as (label, register)
+ERROR_STATS = [('symbol/length', 'STATS0'), ('resource/overflow', 'STATS1'),
+               ('FCS', 'STATS2')]
+# OA_STATUS0 bits that report errors; PHYINT and RESETC are events
+STATUS0_ERROR_BITS = ['HDRE', 'LOFE', 'RXBOE', 'TXBUE', 'TXBOE', 'TXPE']
+# Kernel counters; oa_tc6 accounts its SPI and buffer errors as drops
+NETDEV_COUNTERS = ['tx_packets', 'rx_packets', 'tx_errors', 'rx_errors',
+                   'tx_dropped', 'rx_dropped']
+STATS_REGS = [name for _, frames, total in FRAME_STATS for name in (frames, total)] + \
+             [name for _, name in ERROR_STATS]
+
+class Monitor:
+    def __init__(self, debugfs, addresses, snapstats=False):
+        self.debugfs = debugfs
+        self.addresses = addresses
+        self.snapstats = snapstats and any(LAN8651_REGISTERS[name] in addresses
+                                           for name in STATS_REGS)
+        self.iface = debugfs.sysfs_path.split('/')[-2] if debugfs.sysfs_path else None
+        self.reset()
+
+    def reset(self):
+        """Clear all accumulated counters"""
+        self.refreshes = 0
+        self.failed = 0
+        self.prev = None
+        self.prev_time = None
+        self.prev_netdev = None
+        self.rates = {}
+        self.netdev_rates = {}
+        self.status0_counts = {name: 0 for name in STATUS0_ERROR_BITS}
+        self.status1_counts = {}
+        self.txc_range = None
+        self.rba_range = None
+        self.latency_ms = 0.0
+        self.latency_max_ms = 0.0
+        self.backend = None
+
+    def read_netdev_counters(self):
+        """Frame counters kept by the kernel, costing no SPI access"""
+        counters = {}
+        if not self.iface:
+            return counters
+        for name in NETDEV_COUNTERS:
+            try:
+                with open(f"/sys/class/net/{self.iface}/statistics/{name}") as f:
+                    counters[name] = int(f.read())
+            except (OSError, ValueError):
+                pass
+        return counters
+
+    def link_state(self):
+        """Link state as seen by the network stack"""
+        if not self.iface:
+            return 'unknown'
+        try:
+            with open(f"/sys/class/net/{self.iface}/operstate") as f:
+                return f.read().strip()
+        except OSError:
+            return 'unknown'
+
+    def refresh(self):
+        """Take one batched snapshot and update rates and counters"""
+        start = time.monotonic()
+        if self.snapstats:
+            self.debugfs.write_register(LAN8651_REGISTERS['BMGR_CTL'],
+                                        LAN8651_BMGR_CTL_SNAPSTATS)
+        self.backend, values = self.debugfs.read_registers(self.addresses)
+        now = time.monotonic()
+        netdev = self.read_netdev_counters()
+
+        self.refreshes += 1
+        self.latency_ms = (now - start) * 1000
+        self.latency_max_ms = max(self.latency_max_ms, self.latency_ms)
+        if not values:
+            self.failed += 1
+            return {}
+
+        if self.prev is not None:
+            dt = now - self.prev_time
+            for name in STATS_REGS:
+                address = LAN8651_REGISTERS[name]
+                if address in values and address in self.prev:
+                    delta = (values[address] - self.prev[address]) & 0xFFFFFFFF
+                    self.rates[name] = delta / dt
+            for name, value in netdev.items():
+                if name in self.prev_netdev:
+                    self.netdev_rates[name] = (value - self.prev_netdev[name]) / dt
+
+        status0 = values.get(LAN8651_REGISTERS['OA_STATUS0'])
+        if status0 is not None:
+            for name in STATUS0_ERROR_BITS:
+                if status0 & LAN8651_STATUS0_BITS[name]:
+                    self.status0_counts[name] += 1
+
+        status1 = values.get(LAN8651_REGISTERS['OA_STATUS1'])
+        if status1 is not None:
+            for bit in range(32):
+                if status1 & (1 << bit):
+                    self.status1_counts[bit] = self.status1_counts.get(bit, 0) + 1
+
+        bufsts = values.get(LAN8651_REGISTERS['OA_BUFSTS'])
+        if bufsts is not None:
+            txc = (bufsts >> 8) & 0xFF
+            rba = bufsts & 0xFF
+            self.txc_range = (min(self.txc_range[0], txc), max(self.txc_range[1], txc)) \
+                if self.txc_range else (txc, txc)
+            self.rba_range = (min(self.rba_range[0], rba), max(self.rba_range[1], rba)) \
+                if self.rba_range else (rba, rba)
+
+        self.prev = values
+        self.prev_time = now
+        self.prev_netdev = netdev
+        return values
+
+    def render(self, values, interval):
+        """Format the current state as a list of lines"""
+        lines = []
+        duty = self.latency_ms / (interval * 1000) * 100
+        lines.append(f"LAN8651 monitor - {self.iface or 'no interface'} "
+                     f"via {self.backend or 'none'} - refresh {interval:.2f} s "
+                     f"(q quit, +/- interval, r reset)")
+        lines.append(f"Register access: {len(self.addresses)} regs/refresh, "
+                     f"{self.latency_ms:.1f} ms last, {self.latency_max_ms:.1f} ms max, "
+                     f"{duty:.1f}% of interval, {self.failed}/{self.refreshes} failed")
+        lines.append("")
+
+        basic_status = values.get(LAN8651_REGISTERS['BASIC_STATUS'])
+        phy_link = '?' if basic_status is None else \
+            ('up' if basic_status & LAN8651_BASIC_STATUS_BITS['LSTATUS'] else 'down')
+        lines.append(f"Link: netdev {self.link_state()}, PHY {phy_link}")
+
+        tx = self.netdev_rates.get('tx_packets')
+        rx = self.netdev_rates.get('rx_packets')
+        if tx is not None and rx is not None:
+            lines.append(f"Netdev frames/s:  TX {tx:10.1f}   RX {rx:10.1f}")
+        errors = "   ".join(f"{label} {self.netdev_rates[name]:.1f}"
+                            for label, name in (('TX err', 'tx_errors'), ('RX err', 'rx_errors'),
+                                                ('TX drop', 'tx_dropped'), ('RX drop', 'rx_dropped'))
+                            if name in self.netdev_rates)
+        if errors:
+            lines.append(f"Netdev errors/s:  {errors}")
+        frames = "   ".join(f"{label} {self.rates[name]:10.1f} (total {self.rates[total]:.1f})"
+                            for label, name, total in FRAME_STATS
+                            if name in self.rates and total in self.rates)
+        if frames:
+            lines.append(f"MAC frames/s:     {frames}")
+        errors = "   ".join(f"{label} {self.rates[name]:.1f}"
+                            for label, name in ERROR_STATS if name in self.rates)
+        if errors:
+            lines.append(f"MAC errors/s:     {errors}")
+        lines.append("")
+
+        bufsts = values.get(LAN8651_REGISTERS['OA_BUFSTS'])
+        if bufsts is not None:
+            lines.append(f"OA_BUFSTS: TXC {(bufsts >> 8) & 0xFF:3d} "
+                         f"(min {self.txc_range[0]}, max {self.txc_range[1]})   "
+                         f"RBA {bufsts & 0xFF:3d} "
+                         f"(min {self.rba_range[0]}, max {self.rba_range[1]})")
+            lines.append("")
+
+        # oa_tc6 clears OA_STATUS0 as soon as a footer flags it, so these only
+        # count errors still latched when the refresh happened to sample them
+        lines.append("OA_STATUS0 error bits set when sampled (refreshes):")
+        lines.append("  " + "  ".join(f"{name} {count}"
+                                      for name, count in self.status0_counts.items()))
+        if self.status1_counts:
+            lines.append("OA_STATUS1 bits set when sampled (refreshes):")
+            lines.append("  " + "  ".join(f"bit{bit} {count}"
+                                          for bit, count in sorted(self.status1_counts.items())))
+        lines.append("")
+
+        lines.append("Registers:")
+        for address in self.addresses:
+            value = values.get(address)
+            text = f"0x{value:08X}" if value is not None else "--------"
+            lines.append(f"  {get_register_name(address):<15} {text}")
+        return lines
+
+def run_curses(stdscr, monitor, interval):
+    curses.curs_set(0)
+    stdscr.nodelay(True)
+
+    while True:
+        values = monitor.refresh()
+        stdscr.erase()
+        height, width = stdscr.getmaxyx()
+        for row, line in enumerate(monitor.render(values, interval)[:height - 1]):
+            stdscr.addnstr(row, 0, line, width - 1)
+        stdscr.refresh()
+
+        # Sleep in small steps so key presses are handled promptly
+        deadline = time.monotonic() + interval
+        while time.monotonic() < deadline:
+            key = stdscr.getch()
+            if key in (ord('q'), ord('Q')):
+                return
+            elif key == ord('+'):
+                interval = min(interval * 2, 60.0)
+            elif key == ord('-'):
+                interval = max(interval / 2, 0.05)
+            elif key in (ord('r'), ord('R')):
+                monitor.reset()
+            time.sleep(0.02)
+
+def main():
+    parser = argparse.ArgumentParser(description="Live LAN8651 monitor")
+    parser.add_argument('-i', '--interval', type=float, default=1.0,
+                        help="refresh interval in seconds (default: 1.0)")
+    parser.add_argument('-r', '--regs',
+                        help="comma separated registers to read per refresh "
+                             f"(default: {','.join(DEFAULT_MONITOR_REGS)})")
+    parser.add_argument('-n', '--iterations', type=int,
+                        help="print N refreshes as plain text instead of curses")
+    parser.add_argument('--snapstats', action='store_true',
+                        help="latch the MAC statistics with BMGR_CTL SNAPSTATS "
+                             "before every refresh")
+    args = parser.parse_args()
+
+    if args.interval <= 0:
+        parser.error("interval must be positive")
+
+    names = args.regs.split(',') if args.regs else DEFAULT_MONITOR_REGS
+    try:
+        addresses = [parse_register_address(name.strip()) for name in names]
+    except ValueError as e:
+        parser.error(str(e))
+
+    # One debugfs/netlink handle for the monitor's lifetime
+    debugfs = LAN8651Debugfs()
+    monitor = Monitor(debugfs, addresses, args.snapstats)
+
+    try:
+        if args.iterations:
+            for i in range(args.iterations):
+                if i:
+                    time.sleep(args.interval)
+                values = monitor.refresh()
+                print("\n".join(monitor.render(values, args.interval)))
+                print()
+        else:
+            curses.wrapper(run_curses, monitor, args.interval)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        debugfs.close()
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
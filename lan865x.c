@@ -10,14 +10,75 @@
 
 #include <linux/module.h>
 #include <linux/kernel.h>
+#include <linux/lockdep.h>
+#include <linux/bitfield.h>
+#include <linux/hrtimer.h>
+#include <linux/irq.h>
+#include <linux/mutex.h>
+#include <linux/netdevice.h>
 #include <linux/phy.h>
 #include <linux/oa_tc6.h>
 #include <linux/debugfs.h>
+#include <linux/pm_runtime.h>
 #include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/ratelimit.h>
+#include <linux/u64_stats_sync.h>
+#include <net/devlink.h>
+#include <net/genetlink.h>
+
+#include "lan865x_nl.h"
 
 
 #define DRV_NAME			"lan8650"
 
+/* OPEN Alliance Identification Register */
+#define LAN865X_REG_OA_ID		0x00000000
+#define OA_ID_MAJVER			GENMASK(7, 4)
+#define OA_ID_MAJVER_1			1
+
+/* OPEN Alliance PHY Identification Register */
+#define LAN865X_REG_OA_PHYID		0x00000001
+
+/* OPEN Alliance Configuration 0 Register */
+#define LAN865X_REG_OA_CONFIG0		0x00000004
+
+/* OPEN Alliance Status 0 Register */
+#define LAN865X_REG_OA_STATUS0		0x00000008
+#define OA_STATUS0_TXPE			BIT(0) /* TX Protocol Error */
+#define OA_STATUS0_TXBOE		BIT(1) /* TX Buffer Overflow Error */
+#define OA_STATUS0_TXBUE		BIT(2) /* TX Buffer Underflow Error */
+#define OA_STATUS0_RXBOE		BIT(3) /* RX Buffer Overflow Error */
+#define OA_STATUS0_LOFE			BIT(4) /* Loss of Framing Error */
+#define OA_STATUS0_HDRE			BIT(5) /* Header Error */
+#define OA_STATUS0_RESETC		BIT(6) /* Reset Complete */
+#define OA_STATUS0_TXFCSE		BIT(11) /* TX Frame Check Sequence Error */
+#define OA_STATUS0_CPDE			BIT(12) /* Control Data Protection Error */
+#define OA_STATUS0_ERRORS		(OA_STATUS0_TXPE | OA_STATUS0_TXBOE | \
+					 OA_STATUS0_TXBUE | OA_STATUS0_RXBOE | \
+					 OA_STATUS0_LOFE | OA_STATUS0_HDRE | \
+					 OA_STATUS0_TXFCSE | OA_STATUS0_CPDE)
+
+/* OPEN Alliance Status 1 Register */
+#define LAN865X_REG_OA_STATUS1		0x00000009
+#define OA_STATUS1_RXNER		BIT(0) /* RX Non-recoverable Error */
+#define OA_STATUS1_TXNER		BIT(1) /* TX Non-recoverable Error */
+#define OA_STATUS1_FSMSTER		BIT(17) /* FSM State Error */
+#define OA_STATUS1_ECC			BIT(18) /* SRAM ECC Error */
+#define OA_STATUS1_UV18			BIT(19) /* 1.8 V Undervoltage */
+#define OA_STATUS1_BUSER		BIT(20) /* Internal Bus Error */
+#define OA_STATUS1_ERRORS		(OA_STATUS1_RXNER | OA_STATUS1_TXNER | \
+					 OA_STATUS1_FSMSTER | OA_STATUS1_ECC | \
+					 OA_STATUS1_UV18 | OA_STATUS1_BUSER)
+
+/* OPEN Alliance Interrupt Mask 0 and 1 Registers */
+#define LAN865X_REG_OA_IMASK0		0x0000000C
+
+/* OPEN Alliance Buffer Status Register */
+#define LAN865X_REG_OA_BUFSTS		0x0000000B
+#define OA_BUFSTS_TXC			GENMASK(15, 8) /* TX Credits Available */
+#define OA_BUFSTS_RBA			GENMASK(7, 0) /* RX Blocks Available */
+
 /* MAC Network Control Register */
 #define LAN865X_REG_MAC_NET_CTL		0x00010000
 #define MAC_NET_CTL_TXEN		BIT(3) /* Transmit Enable */
@@ -37,16 +98,229 @@
 #define LAN865X_REG_MAC_L_SADDR1	0x00010022
 /* MAC Specific Addr 1 Top Reg */
 #define LAN865X_REG_MAC_H_SADDR1	0x00010023
+/* MAC Specific Addr 2 Bottom Reg */
+#define LAN865X_REG_MAC_L_SADDR2	0x00010024
+/* MAC Specific Addr 2 Top Reg */
+#define LAN865X_REG_MAC_H_SADDR2	0x00010025
 
 /* MAC TSU Timer Increment Register */
 #define LAN865X_REG_MAC_TSU_TIMER_INCR		0x00010077
 #define MAC_TSU_TIMER_INCR_COUNT_NANOSECONDS	0x0028
 
+/* OA_STATUS0, OA_STATUS1, reserved, OA_BUFSTS read in one control transfer */
+#define LAN865X_BUFSTS_SAMPLE_REGS	4
+#define LAN865X_BUFSTS_BUCKETS		32
+/* Telemetry is opt-in, every sample costs one control transaction */
+#define LAN865X_BUFSTS_INTERVAL_MS	0
+/* Re-sample period while the queue is held stopped on low TX credits,
+ * well below the ~1.6 ms a full TX buffer lasts at 10 Mbit/s
+ */
+#define LAN865X_BUFSTS_HOLD_POLL_US	250
+/* Oldest sample a queue stop may be decided on */
+#define LAN865X_BUFSTS_FRESH_US		(2 * LAN865X_BUFSTS_HOLD_POLL_US)
+/* Longest hold before leaving flow control to oa_tc6 alone */
+#define LAN865X_BUFSTS_HOLD_MAX_MS	100
+#define LAN865X_TXC_STOP_THRESH		4
+#define LAN865X_TXC_STOP_THRESH_MAX	16
+#define LAN865X_TXC_HYSTERESIS		4
+
+/* Payload bytes of one OA-TC6 data chunk, i.e. per TX credit */
+#define LAN865X_CHUNK_PAYLOAD		64
+/* Telemetry samples between two reads of the PLCA configuration */
+#define LAN865X_PLCA_REFRESH_SAMPLES	100
+
+#define LAN865X_SNAPSHOT_MAX		8
+#define LAN865X_SNAPSHOT_INTERVAL	(5 * HZ)
+/* Period of the error watch, independent of the OA_BUFSTS telemetry */
+#define LAN865X_SNAPSHOT_WATCH		HZ
+
+/* MAC-PHY buffer occupancy telemetry sampled from OA_BUFSTS */
+struct lan865x_bufsts {
+	struct delayed_work work;
+	/* Re-samples for the TX queue hold, kicked by the timer and xmit */
+	struct work_struct poll;
+	struct hrtimer timer;
+	/* Serializes samples from the telemetry and the hold poll */
+	struct mutex lock;
+	u32 interval_ms;
+	bool running;
+	bool adaptive;
+	bool queue_stopped;
+	bool txbue;
+	u8 txc;
+	u8 txc_max;
+	u8 stop_thresh;
+	u8 wake_thresh;
+	/* Upper bound on stop_thresh keeping a PLCA burst staged */
+	u8 stop_limit;
+	ktime_t sampled_at;
+	ktime_t hold_until;
+	u64 samples;
+	u64 txbue_events;
+	u64 txc_hist[LAN865X_BUFSTS_BUCKETS];
+	u64 rba_hist[LAN865X_BUFSTS_BUCKETS];
+};
+
+#define LAN865X_COAL_RX_FRAMES		4
+#define LAN865X_COAL_MAX_USECS		10000
+/* Unmasked window in which a latched MAC-PHY interrupt edge is replayed */
+#define LAN865X_COAL_OPEN_US		20
+/* Load evaluation period while moderation is not engaged */
+#define LAN865X_COAL_IDLE_US		10000
+
+/* MAC-PHY interrupt moderation. The interrupt is owned by oa_tc6, so it is
+ * moderated by masking the line: edges arriving while masked are latched by
+ * the IRQ core and replayed on unmask, and one pass of the oa_tc6 SPI thread
+ * then moves every frame that accumulated in the meantime.
+ */
+struct lan865x_coal {
+	struct hrtimer timer;
+	u32 rx_usecs;
+	u32 rx_max_frames;
+	bool adaptive;
+	bool active;
+	bool masked;
+	unsigned long last_frames;
+	ktime_t last_eval;
+	u64_stats_t windows;
+	u64_stats_t frames;
+	struct u64_stats_sync syncp;
+};
+
+/* PLCA burst staging. With a burst configured the node may send up to
+ * 1 + burst_cnt frames per transmit opportunity, but only frames already
+ * in the MAC-PHY TX buffer when the opportunity comes can use it. Each
+ * telemetry sample estimates the frames staged from the used TX credits.
+ */
+struct lan865x_plca {
+	unsigned int refresh;
+	unsigned int burst_frames;
+	unsigned int frame_credits;
+	u64 last_packets;
+	u64 last_bytes;
+	u64_stats_t samples;
+	u64_stats_t burst_full;
+	u64_stats_t burst_partial;
+	u64_stats_t empty;
+	struct u64_stats_sync syncp;
+};
+
+enum lan865x_snapshot_reason {
+	LAN865X_SNAPSHOT_STATUS0,
+	LAN865X_SNAPSHOT_STATUS1,
+	LAN865X_SNAPSHOT_TX_TIMEOUT,
+	LAN865X_SNAPSHOT_NETDEV_ERRORS,
+};
+
+enum lan865x_region {
+	LAN865X_REGION_MMS0,
+	LAN865X_REGION_MMS1,
+	LAN865X_REGION_COUNT,
+};
+
+/* Register dumps published as devlink region snapshots on error events.
+ * Buffers are allocated ahead of time, so a capture is nothing but the
+ * batched register reads; devlink takes ownership of a buffer once its
+ * snapshot is created and the next one is allocated afterwards.
+ */
+struct lan865x_snapshot {
+	struct devlink *devlink;
+	struct devlink_region *regions[LAN865X_REGION_COUNT];
+	u8 *bufs[LAN865X_REGION_COUNT];
+	struct work_struct work;
+	struct delayed_work watch;
+	struct ratelimit_state ratelimit;
+	unsigned long reasons;
+	u32 status0;
+	u32 status1;
+	/* OA_STATUS1 error bits to clear once they are captured */
+	atomic_t status1_clear;
+	unsigned long netdev_errors;
+	u32 last_id;
+	unsigned long last_reasons;
+	u64 taken;
+	u64 failed;
+	atomic_t rate_limited;
+};
+
+#define LAN865X_PM_FIRST_XMIT		0
+
+/* Configuration saved on suspend and written back on resume. Every group
+ * covers consecutive registers, so each is restored with one control
+ * transaction.
+ */
+struct lan865x_pm {
+	u32 config0;
+	u32 imask[2];		/* OA_IMASK0, OA_IMASK1 */
+	u32 mac_ctl[2];		/* MAC_NET_CTL, MAC_NET_CFG */
+	u32 mac_filter[4];	/* MAC hash bottom/top, SADDR1 bottom/top */
+	bool was_up;
+	unsigned long flags;
+	ktime_t resume_start;
+	u32 resumes;
+	u32 power_lost;
+	u32 restore_us;
+	u32 restore_us_max;
+	u32 resume_us;
+	u32 first_xmit_us;
+};
+
+/* Per-CPU software datapath counters, updated without atomics */
+struct lan865x_pcpu_stats {
+	u64_stats_t tx_packets;
+	u64_stats_t tx_bytes;
+	u64_stats_t tx_busy;
+	u64_stats_t tx_dropped;
+	u64_stats_t tx_queue_stop;
+	u64_stats_t tx_queue_wake;
+	struct u64_stats_sync syncp;
+};
+
+/* Per-CPU counters folded over all CPUs */
+struct lan865x_sw_stats {
+	u64 tx_packets;
+	u64 tx_bytes;
+	u64 tx_busy;
+	u64 tx_dropped;
+	u64 tx_queue_stop;
+	u64 tx_queue_wake;
+	u64 coal_windows;
+	u64 coal_frames;
+	u64 coal_frames_per_window;
+	u64 plca_burst_frames;
+	u64 plca_samples;
+	u64 plca_burst_full;
+	u64 plca_burst_partial;
+	u64 plca_empty;
+};
+
+/* Register lock statistics, only updated with the lock held */
+struct lan865x_reg_stats {
+	u64 acquired;
+	u64 contended;
+	u64 wait_ns;
+	u64 wait_ns_max;
+	u64 hold_ns;
+	u64 hold_ns_max;
+	ktime_t locked_at;
+};
+
 struct lan865x_priv {
+	/* Serializes multi-register sequences, see lan865x_reg_lock() */
+	struct mutex reg_lock;
+	struct lan865x_reg_stats reg_stats;
 	struct work_struct multicast_work;
+	struct lan865x_bufsts bufsts;
+	struct lan865x_coal coal;
+	struct lan865x_plca plca;
+	struct lan865x_pm pm;
+	struct lan865x_snapshot snapshot;
+	struct lan865x_pcpu_stats __percpu *stats;
 	struct net_device *netdev;
 	struct spi_device *spi;
 	struct oa_tc6 *tc6;
+	/* oa_tc6_start_xmit() stopped the queue on its last busy return */
+	bool tx_busy_stopped;
 	
 	/* Debug state */
 	u32 last_reg_addr;
@@ -56,289 +330,2046 @@ struct lan865x_priv {
 	struct dentry *debugfs_regs;
 };
 
-static int lan865x_set_hw_macaddr_low_bytes(struct oa_tc6 *tc6, const u8 *mac)
+/* Register access layer
+ *
+ * Every oa_tc6 register call is one control transaction and atomic on its
+ * own, so a batched read or write of consecutive registers needs no driver
+ * lock. Sequences of several transactions (read-modify-write, paired
+ * registers, multi-block requests) hold reg_lock via lan865x_reg_lock()
+ * and use the __lan865x_*() helpers, which assert it.
+ *
+ * The datapath never takes reg_lock: frames move through oa_tc6 and the
+ * OA_BUFSTS sampler that wakes the queue uses lockless single batched
+ * reads. Long holders, like a multi-block netlink request, therefore delay
+ * other management operations only.
+ */
+static void lan865x_reg_lock(struct lan865x_priv *priv)
+	__acquires(&priv->reg_lock)
+{
+	struct lan865x_reg_stats *st = &priv->reg_stats;
+	u64 wait_ns = 0;
+	ktime_t start;
+
+	if (!mutex_trylock(&priv->reg_lock)) {
+		start = ktime_get();
+		mutex_lock(&priv->reg_lock);
+		wait_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+		st->contended++;
+	}
+
+	st->acquired++;
+	st->wait_ns += wait_ns;
+	st->wait_ns_max = max(st->wait_ns_max, wait_ns);
+	st->locked_at = ktime_get();
+}
+
+static void lan865x_reg_unlock(struct lan865x_priv *priv)
+	__releases(&priv->reg_lock)
+{
+	struct lan865x_reg_stats *st = &priv->reg_stats;
+	u64 hold_ns = ktime_to_ns(ktime_sub(ktime_get(), st->locked_at));
+
+	st->hold_ns += hold_ns;
+	st->hold_ns_max = max(st->hold_ns_max, hold_ns);
+	mutex_unlock(&priv->reg_lock);
+}
+
+static int __lan865x_read_regs(struct lan865x_priv *priv, u32 addr, u32 *val,
+			       u8 count)
+{
+	lockdep_assert_held(&priv->reg_lock);
+
+	return oa_tc6_read_registers(priv->tc6, addr, val, count);
+}
+
+static void lan865x_pm_track_group(u32 *saved, u32 base, u8 n, u32 addr,
+				   const u32 *val, u8 count)
+{
+	for (u8 i = 0; i < count; i++) {
+		if (addr + i >= base && addr + i < base + n)
+			saved[addr + i - base] = val[i];
+	}
+}
+
+/* Writes made while runtime suspended, e.g. a MAC address change on a down
+ * interface or a debugfs/netlink write, must survive the restore on resume,
+ * so keep the saved configuration in step with every register write.
+ */
+static void lan865x_pm_track(struct lan865x_priv *priv, u32 addr,
+			     const u32 *val, u8 count)
+{
+	struct lan865x_pm *pm = &priv->pm;
+
+	lan865x_pm_track_group(&pm->config0, LAN865X_REG_OA_CONFIG0, 1,
+			       addr, val, count);
+	lan865x_pm_track_group(pm->imask, LAN865X_REG_OA_IMASK0,
+			       ARRAY_SIZE(pm->imask), addr, val, count);
+	lan865x_pm_track_group(pm->mac_ctl, LAN865X_REG_MAC_NET_CTL,
+			       ARRAY_SIZE(pm->mac_ctl), addr, val, count);
+	lan865x_pm_track_group(pm->mac_filter, LAN865X_REG_MAC_L_HASH,
+			       ARRAY_SIZE(pm->mac_filter), addr, val, count);
+}
+
+static int __lan865x_write_regs(struct lan865x_priv *priv, u32 addr,
+				u32 *val, u8 count)
+{
+	int ret;
+
+	lockdep_assert_held(&priv->reg_lock);
+
+	ret = oa_tc6_write_registers(priv->tc6, addr, val, count);
+	if (!ret)
+		lan865x_pm_track(priv, addr, val, count);
+
+	return ret;
+}
+
+static int __lan865x_write_reg(struct lan865x_priv *priv, u32 addr, u32 val)
+{
+	return __lan865x_write_regs(priv, addr, &val, 1);
+}
+
+static int __lan865x_modify_reg(struct lan865x_priv *priv, u32 addr,
+				u32 mask, u32 val)
 {
 	u32 regval;
+	int ret;
+
+	ret = __lan865x_read_regs(priv, addr, &regval, 1);
+	if (ret)
+		return ret;
+
+	return __lan865x_write_reg(priv, addr, (regval & ~mask) | val);
+}
+
+static int lan865x_read_regs(struct lan865x_priv *priv, u32 addr, u32 *val,
+			     u8 count)
+{
+	int ret;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_read_regs(priv, addr, val, count);
+	lan865x_reg_unlock(priv);
+
+	return ret;
+}
+
+static int lan865x_write_regs(struct lan865x_priv *priv, u32 addr, u32 *val,
+			      u8 count)
+{
+	int ret;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_write_regs(priv, addr, val, count);
+	lan865x_reg_unlock(priv);
+
+	return ret;
+}
+
+static int lan865x_write_reg(struct lan865x_priv *priv, u32 addr, u32 val)
+{
+	return lan865x_write_regs(priv, addr, &val, 1);
+}
+
+static int lan865x_modify_reg(struct lan865x_priv *priv, u32 addr, u32 mask,
+			      u32 val)
+{
+	int ret;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_modify_reg(priv, addr, mask, val);
+	lan865x_reg_unlock(priv);
+
+	return ret;
+}
+
+static int __lan865x_set_hw_macaddr_low_bytes(struct lan865x_priv *priv,
+					      const u8 *mac)
+{
+	u32 regval;
+
+	lockdep_assert_held(&priv->reg_lock);
 
 	regval = (mac[3] << 24) | (mac[2] << 16) | (mac[1] << 8) | mac[0];
 
-	return oa_tc6_write_register(tc6, LAN865X_REG_MAC_L_SADDR1, regval);
+	return __lan865x_write_reg(priv, LAN865X_REG_MAC_L_SADDR1, regval);
 }
 
-static int lan865x_set_hw_macaddr(struct lan865x_priv *priv, const u8 *mac)
+static int __lan865x_set_hw_macaddr(struct lan865x_priv *priv, const u8 *mac)
 {
 	int restore_ret;
 	u32 regval;
 	int ret;
 
 	/* Configure MAC address low bytes */
-	ret = lan865x_set_hw_macaddr_low_bytes(priv->tc6, mac);
+	ret = __lan865x_set_hw_macaddr_low_bytes(priv, mac);
 	if (ret)
 		return ret;
 
 	/* Prepare and configure MAC address high bytes */
 	regval = (mac[5] << 8) | mac[4];
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_H_SADDR1,
-				    regval);
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_H_SADDR1, regval);
 	if (!ret)
 		return 0;
 
 	/* Restore the old MAC address low bytes from netdev if the new MAC
 	 * address high bytes setting failed.
 	 */
-	restore_ret = lan865x_set_hw_macaddr_low_bytes(priv->tc6,
-						       priv->netdev->dev_addr);
+	restore_ret = __lan865x_set_hw_macaddr_low_bytes(priv,
+							 priv->netdev->dev_addr);
 	if (restore_ret)
 		return restore_ret;
 
 	return ret;
 }
 
-static const struct ethtool_ops lan865x_ethtool_ops = {
-	.get_link_ksettings = phy_ethtool_get_link_ksettings,
-	.set_link_ksettings = phy_ethtool_set_link_ksettings,
+/* Both halves are written, or the old address restored, without another
+ * register user seeing a mixed address.
+ */
+static int lan865x_set_hw_macaddr(struct lan865x_priv *priv, const u8 *mac)
+{
+	int ret;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_set_hw_macaddr(priv, mac);
+	lan865x_reg_unlock(priv);
+
+	return ret;
+}
+
+static const struct {
+	char name[ETH_GSTRING_LEN];
+	size_t offset;
+} lan865x_sw_stats_desc[] = {
+	{ "tx_xmit_packets", offsetof(struct lan865x_sw_stats, tx_packets) },
+	{ "tx_xmit_bytes", offsetof(struct lan865x_sw_stats, tx_bytes) },
+	{ "tx_busy", offsetof(struct lan865x_sw_stats, tx_busy) },
+	{ "tx_dropped", offsetof(struct lan865x_sw_stats, tx_dropped) },
+	{ "tx_queue_stop", offsetof(struct lan865x_sw_stats, tx_queue_stop) },
+	{ "tx_queue_wake", offsetof(struct lan865x_sw_stats, tx_queue_wake) },
+	{ "coal_windows", offsetof(struct lan865x_sw_stats, coal_windows) },
+	{ "coal_frames", offsetof(struct lan865x_sw_stats, coal_frames) },
+	{ "coal_frames_per_window",
+	  offsetof(struct lan865x_sw_stats, coal_frames_per_window) },
+	{ "plca_burst_frames",
+	  offsetof(struct lan865x_sw_stats, plca_burst_frames) },
+	{ "plca_samples", offsetof(struct lan865x_sw_stats, plca_samples) },
+	{ "plca_burst_full", offsetof(struct lan865x_sw_stats, plca_burst_full) },
+	{ "plca_burst_partial",
+	  offsetof(struct lan865x_sw_stats, plca_burst_partial) },
+	{ "plca_empty", offsetof(struct lan865x_sw_stats, plca_empty) },
 };
 
-static int lan865x_set_mac_address(struct net_device *netdev, void *addr)
+enum lan865x_selftest_result {
+	LAN865X_TEST_REG,
+	LAN865X_TEST_LOOPBACK,
+	LAN865X_TEST_FPS_64,
+	LAN865X_TEST_FPS_512,
+	LAN865X_TEST_FPS_1518,
+	LAN865X_TEST_BPS,
+	LAN865X_TEST_LAT_MIN,
+	LAN865X_TEST_LAT_AVG,
+	LAN865X_TEST_LAT_MAX,
+	LAN865X_TEST_COUNT,
+};
+
+static const char lan865x_selftest_strings[][ETH_GSTRING_LEN] = {
+	[LAN865X_TEST_REG]	= "Register test  (on/offline)",
+	[LAN865X_TEST_LOOPBACK]	= "Loopback test  (offline)",
+	[LAN865X_TEST_FPS_64]	= "64B frames/s   (offline)",
+	[LAN865X_TEST_FPS_512]	= "512B frames/s  (offline)",
+	[LAN865X_TEST_FPS_1518]	= "1518B frames/s (offline)",
+	[LAN865X_TEST_BPS]	= "Bytes/s        (offline)",
+	[LAN865X_TEST_LAT_MIN]	= "RTT min us     (offline)",
+	[LAN865X_TEST_LAT_AVG]	= "RTT avg us     (offline)",
+	[LAN865X_TEST_LAT_MAX]	= "RTT max us     (offline)",
+};
+
+static void lan865x_get_sw_stats(struct lan865x_priv *priv,
+				 struct lan865x_sw_stats *tot)
+{
+	unsigned int start;
+	int cpu;
+
+	memset(tot, 0, sizeof(*tot));
+
+	for_each_possible_cpu(cpu) {
+		const struct lan865x_pcpu_stats *stats;
+		u64 packets, bytes, busy, dropped, stop, wake;
+
+		stats = per_cpu_ptr(priv->stats, cpu);
+		do {
+			start = u64_stats_fetch_begin(&stats->syncp);
+			packets = u64_stats_read(&stats->tx_packets);
+			bytes = u64_stats_read(&stats->tx_bytes);
+			busy = u64_stats_read(&stats->tx_busy);
+			dropped = u64_stats_read(&stats->tx_dropped);
+			stop = u64_stats_read(&stats->tx_queue_stop);
+			wake = u64_stats_read(&stats->tx_queue_wake);
+		} while (u64_stats_fetch_retry(&stats->syncp, start));
+
+		tot->tx_packets += packets;
+		tot->tx_bytes += bytes;
+		tot->tx_busy += busy;
+		tot->tx_dropped += dropped;
+		tot->tx_queue_stop += stop;
+		tot->tx_queue_wake += wake;
+	}
+
+	do {
+		start = u64_stats_fetch_begin(&priv->coal.syncp);
+		tot->coal_windows = u64_stats_read(&priv->coal.windows);
+		tot->coal_frames = u64_stats_read(&priv->coal.frames);
+	} while (u64_stats_fetch_retry(&priv->coal.syncp, start));
+
+	if (tot->coal_windows)
+		tot->coal_frames_per_window = div64_u64(tot->coal_frames,
+							tot->coal_windows);
+
+	tot->plca_burst_frames = READ_ONCE(priv->plca.burst_frames);
+	do {
+		start = u64_stats_fetch_begin(&priv->plca.syncp);
+		tot->plca_samples = u64_stats_read(&priv->plca.samples);
+		tot->plca_burst_full = u64_stats_read(&priv->plca.burst_full);
+		tot->plca_burst_partial =
+			u64_stats_read(&priv->plca.burst_partial);
+		tot->plca_empty = u64_stats_read(&priv->plca.empty);
+	} while (u64_stats_fetch_retry(&priv->plca.syncp, start));
+}
+
+static int lan865x_get_sset_count(struct net_device *netdev, int sset)
+{
+	switch (sset) {
+	case ETH_SS_STATS:
+		return ARRAY_SIZE(lan865x_sw_stats_desc);
+	case ETH_SS_TEST:
+		return LAN865X_TEST_COUNT;
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+static void lan865x_get_strings(struct net_device *netdev, u32 sset, u8 *data)
+{
+	switch (sset) {
+	case ETH_SS_STATS:
+		for (int i = 0; i < ARRAY_SIZE(lan865x_sw_stats_desc); i++)
+			ethtool_puts(&data, lan865x_sw_stats_desc[i].name);
+		break;
+	case ETH_SS_TEST:
+		memcpy(data, lan865x_selftest_strings,
+		       sizeof(lan865x_selftest_strings));
+		break;
+	}
+}
+
+static void lan865x_get_ethtool_stats(struct net_device *netdev,
+				      struct ethtool_stats *estats, u64 *data)
 {
 	struct lan865x_priv *priv = netdev_priv(netdev);
-	struct sockaddr *address = addr;
-	int ret;
+	struct lan865x_sw_stats sw;
 
-	ret = eth_prepare_mac_addr_change(netdev, addr);
-	if (ret < 0)
-		return ret;
+	lan865x_get_sw_stats(priv, &sw);
 
-	if (ether_addr_equal(address->sa_data, netdev->dev_addr))
-		return 0;
+	for (int i = 0; i < ARRAY_SIZE(lan865x_sw_stats_desc); i++)
+		data[i] = *(u64 *)((u8 *)&sw + lan865x_sw_stats_desc[i].offset);
+}
 
-	ret = lan865x_set_hw_macaddr(priv, address->sa_data);
-	if (ret)
-		return ret;
+static unsigned long lan865x_coal_frames(struct net_device *netdev)
+{
+	return READ_ONCE(netdev->stats.rx_packets) +
+	       READ_ONCE(netdev->stats.tx_packets);
+}
 
-	eth_commit_mac_addr_change(netdev, addr);
+/* Decide from the frames moved since the last evaluation whether the next
+ * period should be moderated. The adaptive mode only trades latency for
+ * throughput once the load reaches rx_max_frames per moderation period.
+ */
+static bool lan865x_coal_engage(struct lan865x_coal *coal,
+				unsigned long frames, ktime_t now)
+{
+	unsigned long delta = frames - coal->last_frames;
+	s64 elapsed_us = ktime_us_delta(now, coal->last_eval);
 
-	return 0;
+	if (!delta)
+		return false;
+
+	if (!coal->adaptive)
+		return true;
+
+	if (elapsed_us <= 0)
+		return false;
+
+	return div64_u64((u64)delta * coal->rx_usecs, elapsed_us) >=
+	       coal->rx_max_frames;
 }
 
-static u32 get_address_bit(u8 addr[ETH_ALEN], u32 bit)
+static enum hrtimer_restart lan865x_coal_timer(struct hrtimer *timer)
 {
-	return ((addr[bit / 8]) >> (bit % 8)) & 1;
+	struct lan865x_coal *coal = container_of(timer, struct lan865x_coal,
+						 timer);
+	struct lan865x_priv *priv = container_of(coal, struct lan865x_priv,
+						 coal);
+	ktime_t now = ktime_get();
+	unsigned long frames;
+	u32 period_us;
+
+	if (coal->masked) {
+		enable_irq(priv->spi->irq);
+		coal->masked = false;
+		hrtimer_forward_now(timer, us_to_ktime(LAN865X_COAL_OPEN_US));
+		return HRTIMER_RESTART;
+	}
+
+	frames = lan865x_coal_frames(priv->netdev);
+	if (coal->active) {
+		u64_stats_update_begin(&coal->syncp);
+		u64_stats_inc(&coal->windows);
+		u64_stats_add(&coal->frames, frames - coal->last_frames);
+		u64_stats_update_end(&coal->syncp);
+	}
+
+	coal->active = lan865x_coal_engage(coal, frames, now);
+	coal->last_frames = frames;
+	coal->last_eval = now;
+
+	if (coal->active) {
+		disable_irq_nosync(priv->spi->irq);
+		coal->masked = true;
+		period_us = coal->rx_usecs;
+	} else {
+		period_us = LAN865X_COAL_IDLE_US;
+	}
+
+	hrtimer_forward_now(timer, us_to_ktime(period_us));
+
+	return HRTIMER_RESTART;
 }
 
-static u32 lan865x_hash(u8 addr[ETH_ALEN])
+static void lan865x_coal_start(struct lan865x_priv *priv)
 {
-	u32 hash_index = 0;
+	struct lan865x_coal *coal = &priv->coal;
 
-	for (int i = 0; i < 6; i++) {
-		u32 hash = 0;
+	if (!coal->rx_usecs)
+		return;
 
-		for (int j = 0; j < 8; j++)
-			hash ^= get_address_bit(addr, (j * 6) + i);
+	coal->active = false;
+	coal->last_frames = lan865x_coal_frames(priv->netdev);
+	coal->last_eval = ktime_get();
+	hrtimer_start(&coal->timer, us_to_ktime(LAN865X_COAL_IDLE_US),
+		      HRTIMER_MODE_REL);
+}
 
-		hash_index |= (hash << i);
+static void lan865x_coal_stop(struct lan865x_priv *priv)
+{
+	struct lan865x_coal *coal = &priv->coal;
+
+	hrtimer_cancel(&coal->timer);
+
+	/* Keep the IRQ disable depth balanced */
+	if (coal->masked) {
+		enable_irq(priv->spi->irq);
+		coal->masked = false;
 	}
+	coal->active = false;
+}
 
-	return hash_index;
+static int lan865x_get_coalesce(struct net_device *netdev,
+				struct ethtool_coalesce *ec,
+				struct kernel_ethtool_coalesce *kec,
+				struct netlink_ext_ack *extack)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+
+	ec->rx_coalesce_usecs = priv->coal.rx_usecs;
+	ec->rx_max_coalesced_frames = priv->coal.rx_max_frames;
+	ec->use_adaptive_rx_coalesce = priv->coal.adaptive;
+
+	return 0;
 }
 
-static int lan865x_set_specific_multicast_addr(struct lan865x_priv *priv)
+static int lan865x_set_coalesce(struct net_device *netdev,
+				struct ethtool_coalesce *ec,
+				struct kernel_ethtool_coalesce *kec,
+				struct netlink_ext_ack *extack)
 {
-	struct netdev_hw_addr *ha;
-	u32 hash_lo = 0;
-	u32 hash_hi = 0;
-	int ret;
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	struct irq_chip *chip = irq_get_chip(priv->spi->irq);
 
-	netdev_for_each_mc_addr(ha, priv->netdev) {
-		u32 bit_num = lan865x_hash(ha->addr);
+	if (ec->rx_coalesce_usecs > LAN865X_COAL_MAX_USECS) {
+		NL_SET_ERR_MSG_FMT_MOD(extack, "rx-usecs must not exceed %u",
+				       LAN865X_COAL_MAX_USECS);
+		return -EINVAL;
+	}
 
-		if (bit_num >= BIT(5))
-			hash_hi |= (1 << (bit_num - BIT(5)));
-		else
-			hash_lo |= (1 << bit_num);
+	if (!ec->rx_max_coalesced_frames) {
+		NL_SET_ERR_MSG_MOD(extack, "rx-frames must be at least 1");
+		return -EINVAL;
 	}
 
-	/* Enabling specific multicast addresses */
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_H_HASH, hash_hi);
-	if (ret) {
-		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
-			   ret);
-		return ret;
+	/* Fixed moderation masks for rx-usecs regardless of the load */
+	if (!ec->use_adaptive_rx_coalesce &&
+	    ec->rx_max_coalesced_frames != priv->coal.rx_max_frames) {
+		NL_SET_ERR_MSG_MOD(extack, "rx-frames requires adaptive-rx on");
+		return -EINVAL;
 	}
 
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_L_HASH, hash_lo);
-	if (ret)
-		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
-			   ret);
+	/* The line is masked and unmasked from hrtimer context */
+	if (ec->rx_coalesce_usecs && chip && chip->irq_bus_lock) {
+		NL_SET_ERR_MSG_MOD(extack,
+				   "interrupt controller cannot be masked from atomic context");
+		return -EOPNOTSUPP;
+	}
 
-	return ret;
+	if (netif_running(netdev))
+		lan865x_coal_stop(priv);
+
+	priv->coal.rx_usecs = ec->rx_coalesce_usecs;
+	priv->coal.rx_max_frames = ec->rx_max_coalesced_frames;
+	priv->coal.adaptive = ec->use_adaptive_rx_coalesce;
+
+	if (netif_running(netdev))
+		lan865x_coal_start(priv);
+
+	return 0;
 }
 
-static int lan865x_set_all_multicast_addr(struct lan865x_priv *priv)
+#define LAN865X_SELFTEST_MAGIC		0x4c383635 /* "L865" */
+#define LAN865X_SELFTEST_BURST		64
+#define LAN865X_SELFTEST_PINGS		16
+#define LAN865X_SELFTEST_TIMEOUT_MS	500
+#define LAN865X_SELFTEST_PATTERN	0x5a5aa5a5
+
+struct lan865x_selftest_hdr {
+	__be32 magic;
+	__be32 round;
+} __packed;
+
+/* Loopback frames are matched by a private packet handler; each round only
+ * accepts its own frames so stragglers of a timed out round are ignored.
+ */
+struct lan865x_selftest {
+	struct packet_type pt;
+	struct completion done;
+	spinlock_t lock;
+	u32 round;
+	u32 expected;
+	u32 received;
+	ktime_t last_rx;
+};
+
+/* Frame lengths without FCS, for 64, 512 and 1518 bytes on the wire */
+static const unsigned int lan865x_selftest_lens[] = { 60, 508, 1514 };
+
+static int lan865x_selftest_regs(struct lan865x_priv *priv)
 {
+	u32 saved[2];
+	u32 regval;
+	u32 id[2];
 	int ret;
 
-	/* Enabling all multicast addresses */
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_H_HASH,
-				    0xffffffff);
-	if (ret) {
-		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
-			   ret);
+	/* MMS 0: Open Alliance standard registers, OA_ID and OA_PHYID */
+	ret = lan865x_read_regs(priv, LAN865X_REG_OA_ID, id, ARRAY_SIZE(id));
+	if (ret)
 		return ret;
-	}
+	if (FIELD_GET(OA_ID_MAJVER, id[0]) != OA_ID_MAJVER_1)
+		return -EIO;
+	if (!id[1] || id[1] == U32_MAX)
+		return -EIO;
+
+	/* MMS 1: write and read back the unused specific address 2 filter */
+	lan865x_reg_lock(priv);
 
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_L_HASH,
-				    0xffffffff);
+	ret = __lan865x_read_regs(priv, LAN865X_REG_MAC_L_SADDR2, saved,
+				  ARRAY_SIZE(saved));
 	if (ret)
-		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
-			   ret);
+		goto unlock;
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_L_SADDR2,
+				  LAN865X_SELFTEST_PATTERN);
+	if (!ret)
+		ret = __lan865x_read_regs(priv, LAN865X_REG_MAC_L_SADDR2,
+					  &regval, 1);
+	if (!ret && regval != LAN865X_SELFTEST_PATTERN)
+		ret = -EIO;
+
+	/* Writing the top half re-arms the filter, so restore both halves */
+	if (__lan865x_write_regs(priv, LAN865X_REG_MAC_L_SADDR2, saved,
+				 ARRAY_SIZE(saved)) && !ret)
+		ret = -EIO;
+
+unlock:
+	lan865x_reg_unlock(priv);
 
 	return ret;
 }
 
-static int lan865x_clear_all_multicast_addr(struct lan865x_priv *priv)
+static int lan865x_selftest_rcv(struct sk_buff *skb, struct net_device *netdev,
+				struct packet_type *pt,
+				struct net_device *orig_dev)
 {
-	int ret;
+	struct lan865x_selftest *st = pt->af_packet_priv;
+	const struct lan865x_selftest_hdr *hdr;
+	struct lan865x_selftest_hdr _hdr;
 
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_H_HASH, 0);
-	if (ret) {
-		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
-			   ret);
-		return ret;
+	/* The skb is shared with other taps, so read without pulling */
+	hdr = skb_header_pointer(skb, 0, sizeof(_hdr), &_hdr);
+	if (!hdr)
+		goto out;
+
+	if (hdr->magic != cpu_to_be32(LAN865X_SELFTEST_MAGIC))
+		goto out;
+
+	spin_lock(&st->lock);
+	if (be32_to_cpu(hdr->round) == st->round &&
+	    st->received < st->expected) {
+		st->last_rx = ktime_get();
+		if (++st->received == st->expected)
+			complete(&st->done);
 	}
+	spin_unlock(&st->lock);
 
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_L_HASH, 0);
-	if (ret)
-		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
-			   ret);
+out:
+	consume_skb(skb);
+	return NET_RX_SUCCESS;
+}
 
-	return ret;
+static void lan865x_selftest_arm(struct lan865x_selftest *st, u32 expected)
+{
+	spin_lock_bh(&st->lock);
+	st->round++;
+	st->expected = expected;
+	st->received = 0;
+	reinit_completion(&st->done);
+	spin_unlock_bh(&st->lock);
 }
 
-static void lan865x_multicast_work_handler(struct work_struct *work)
+static int lan865x_selftest_xmit(struct net_device *netdev,
+				 struct lan865x_selftest *st, unsigned int len)
 {
-	struct lan865x_priv *priv = container_of(work, struct lan865x_priv,
-						 multicast_work);
-	u32 regval = 0;
+	struct lan865x_selftest_hdr *hdr;
+	struct sk_buff *skb;
+	struct ethhdr *eth;
 	int ret;
 
-	if (priv->netdev->flags & IFF_PROMISC) {
-		/* Enabling promiscuous mode */
-		regval |= MAC_NET_CFG_PROMISCUOUS_MODE;
-		regval &= (~MAC_NET_CFG_MULTICAST_MODE);
-		regval &= (~MAC_NET_CFG_UNICAST_MODE);
-	} else if (priv->netdev->flags & IFF_ALLMULTI) {
-		/* Enabling all multicast mode */
-		if (lan865x_set_all_multicast_addr(priv))
-			return;
+	skb = netdev_alloc_skb(netdev, len);
+	if (!skb)
+		return -ENOMEM;
+
+	eth = skb_put(skb, ETH_HLEN);
+	ether_addr_copy(eth->h_dest, netdev->dev_addr);
+	ether_addr_copy(eth->h_source, netdev->dev_addr);
+	eth->h_proto = htons(ETH_P_802_EX1);
+
+	hdr = skb_put(skb, sizeof(*hdr));
+	hdr->magic = cpu_to_be32(LAN865X_SELFTEST_MAGIC);
+	hdr->round = cpu_to_be32(st->round);
+	skb_put_zero(skb, len - ETH_HLEN - sizeof(*hdr));
+
+	skb_reset_mac_header(skb);
+	skb->protocol = htons(ETH_P_802_EX1);
+	skb->dev = netdev;
+
+	ret = net_xmit_eval(dev_queue_xmit(skb));
+
+	return ret > 0 ? -ENOBUFS : ret;
+}
+
+static int lan865x_selftest_wait(struct lan865x_selftest *st)
+{
+	if (!wait_for_completion_timeout(&st->done,
+					 msecs_to_jiffies(LAN865X_SELFTEST_TIMEOUT_MS)))
+		return -ETIMEDOUT;
+
+	return 0;
+}
+
+/* Push a burst of each frame size through the full SPI chunk path */
+static int lan865x_selftest_throughput(struct net_device *netdev,
+				       struct lan865x_selftest *st, u64 *data)
+{
+	u64 total_bytes = 0;
+	s64 total_ns = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(lan865x_selftest_lens); i++) {
+		unsigned int len = lan865x_selftest_lens[i];
+		ktime_t start;
+		s64 elapsed;
+		int ret;
+
+		lan865x_selftest_arm(st, LAN865X_SELFTEST_BURST);
+		start = ktime_get();
+		for (int n = 0; n < LAN865X_SELFTEST_BURST; n++) {
+			ret = lan865x_selftest_xmit(netdev, st, len);
+			if (ret)
+				return ret;
+		}
+
+		ret = lan865x_selftest_wait(st);
+		if (ret)
+			return ret;
+
+		elapsed = max_t(s64, ktime_to_ns(ktime_sub(st->last_rx, start)), 1);
+		data[LAN865X_TEST_FPS_64 + i] =
+			div64_u64((u64)LAN865X_SELFTEST_BURST * NSEC_PER_SEC,
+				  elapsed);
+		total_bytes += (u64)LAN865X_SELFTEST_BURST * (len + ETH_FCS_LEN);
+		total_ns += elapsed;
+	}
+
+	data[LAN865X_TEST_BPS] = div64_u64(total_bytes * NSEC_PER_SEC, total_ns);
+
+	return 0;
+}
+
+/* Round-trip latency of single minimum size frames on an idle path */
+static int lan865x_selftest_latency(struct net_device *netdev,
+				    struct lan865x_selftest *st, u64 *data)
+{
+	u64 min_ns = U64_MAX, max_ns = 0, sum_ns = 0;
+
+	for (int n = 0; n < LAN865X_SELFTEST_PINGS; n++) {
+		ktime_t start;
+		u64 rtt;
+		int ret;
+
+		lan865x_selftest_arm(st, 1);
+		start = ktime_get();
+		ret = lan865x_selftest_xmit(netdev, st, lan865x_selftest_lens[0]);
+		if (ret)
+			return ret;
+
+		ret = lan865x_selftest_wait(st);
+		if (ret)
+			return ret;
+
+		rtt = ktime_to_ns(ktime_sub(st->last_rx, start));
+		min_ns = min(min_ns, rtt);
+		max_ns = max(max_ns, rtt);
+		sum_ns += rtt;
+	}
+
+	data[LAN865X_TEST_LAT_MIN] = div_u64(min_ns, NSEC_PER_USEC);
+	data[LAN865X_TEST_LAT_AVG] = div_u64(sum_ns, LAN865X_SELFTEST_PINGS *
+					     NSEC_PER_USEC);
+	data[LAN865X_TEST_LAT_MAX] = div_u64(max_ns, NSEC_PER_USEC);
+
+	return 0;
+}
+
+static int lan865x_selftest_loopback(struct lan865x_priv *priv, u64 *data)
+{
+	struct net_device *netdev = priv->netdev;
+	struct lan865x_selftest *st;
+	int ret;
+
+	if (!netif_running(netdev) || !netdev->phydev)
+		return -ENETDOWN;
+
+	st = kzalloc(sizeof(*st), GFP_KERNEL);
+	if (!st)
+		return -ENOMEM;
+
+	spin_lock_init(&st->lock);
+	init_completion(&st->done);
+	st->pt.type = htons(ETH_P_802_EX1);
+	st->pt.func = lan865x_selftest_rcv;
+	st->pt.dev = netdev;
+	st->pt.af_packet_priv = st;
+
+	ret = phy_loopback(netdev->phydev, true);
+	if (ret)
+		goto free_st;
+
+	dev_add_pack(&st->pt);
+
+	ret = lan865x_selftest_latency(netdev, st, data);
+	if (!ret)
+		ret = lan865x_selftest_throughput(netdev, st, data);
+
+	/* Also waits for handlers still running on other CPUs */
+	dev_remove_pack(&st->pt);
+	phy_loopback(netdev->phydev, false);
+
+free_st:
+	kfree(st);
+	return ret;
+}
+
+static void lan865x_self_test(struct net_device *netdev,
+			      struct ethtool_test *etest, u64 *data)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	int ret;
+
+	memset(data, 0, LAN865X_TEST_COUNT * sizeof(*data));
+
+	ret = lan865x_selftest_regs(priv);
+	if (ret) {
+		netdev_err(netdev, "Register self-test failed: %d\n", ret);
+		data[LAN865X_TEST_REG] = 1;
+		etest->flags |= ETH_TEST_FL_FAILED;
+	}
+
+	if (!(etest->flags & ETH_TEST_FL_OFFLINE))
+		return;
+
+	ret = lan865x_selftest_loopback(priv, data);
+	if (ret) {
+		netdev_err(netdev, "Loopback self-test failed: %d\n", ret);
+		data[LAN865X_TEST_LOOPBACK] = 1;
+		etest->flags |= ETH_TEST_FL_FAILED;
+	}
+}
+
+static const struct ethtool_ops lan865x_ethtool_ops = {
+	.supported_coalesce_params = ETHTOOL_COALESCE_RX_USECS |
+				     ETHTOOL_COALESCE_RX_MAX_FRAMES |
+				     ETHTOOL_COALESCE_USE_ADAPTIVE_RX,
+	.get_link_ksettings = phy_ethtool_get_link_ksettings,
+	.set_link_ksettings = phy_ethtool_set_link_ksettings,
+	.get_sset_count = lan865x_get_sset_count,
+	.get_strings = lan865x_get_strings,
+	.get_ethtool_stats = lan865x_get_ethtool_stats,
+	.get_coalesce = lan865x_get_coalesce,
+	.set_coalesce = lan865x_set_coalesce,
+	.self_test = lan865x_self_test,
+};
+
+static int lan865x_set_mac_address(struct net_device *netdev, void *addr)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	struct sockaddr *address = addr;
+	int ret;
+
+	ret = eth_prepare_mac_addr_change(netdev, addr);
+	if (ret < 0)
+		return ret;
+
+	if (ether_addr_equal(address->sa_data, netdev->dev_addr))
+		return 0;
+
+	ret = lan865x_set_hw_macaddr(priv, address->sa_data);
+	if (ret)
+		return ret;
+
+	eth_commit_mac_addr_change(netdev, addr);
+
+	return 0;
+}
+
+static u32 get_address_bit(u8 addr[ETH_ALEN], u32 bit)
+{
+	return ((addr[bit / 8]) >> (bit % 8)) & 1;
+}
+
+static u32 lan865x_hash(u8 addr[ETH_ALEN])
+{
+	u32 hash_index = 0;
+
+	for (int i = 0; i < 6; i++) {
+		u32 hash = 0;
+
+		for (int j = 0; j < 8; j++)
+			hash ^= get_address_bit(addr, (j * 6) + i);
+
+		hash_index |= (hash << i);
+	}
+
+	return hash_index;
+}
+
+static int __lan865x_set_specific_multicast_addr(struct lan865x_priv *priv)
+{
+	struct netdev_hw_addr *ha;
+	u32 hash_lo = 0;
+	u32 hash_hi = 0;
+	int ret;
+
+	netdev_for_each_mc_addr(ha, priv->netdev) {
+		u32 bit_num = lan865x_hash(ha->addr);
+
+		if (bit_num >= BIT(5))
+			hash_hi |= (1 << (bit_num - BIT(5)));
+		else
+			hash_lo |= (1 << bit_num);
+	}
+
+	/* Enabling specific multicast addresses */
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_H_HASH, hash_hi);
+	if (ret) {
+		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
+			   ret);
+		return ret;
+	}
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_L_HASH, hash_lo);
+	if (ret)
+		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
+			   ret);
+
+	return ret;
+}
+
+static int __lan865x_set_all_multicast_addr(struct lan865x_priv *priv)
+{
+	int ret;
+
+	/* Enabling all multicast addresses */
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_H_HASH, 0xffffffff);
+	if (ret) {
+		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
+			   ret);
+		return ret;
+	}
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_L_HASH, 0xffffffff);
+	if (ret)
+		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
+			   ret);
+
+	return ret;
+}
+
+static int __lan865x_clear_all_multicast_addr(struct lan865x_priv *priv)
+{
+	int ret;
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_H_HASH, 0);
+	if (ret) {
+		netdev_err(priv->netdev, "Failed to write reg_hashh: %d\n",
+			   ret);
+		return ret;
+	}
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_L_HASH, 0);
+	if (ret)
+		netdev_err(priv->netdev, "Failed to write reg_hashl: %d\n",
+			   ret);
+
+	return ret;
+}
+
+static void lan865x_multicast_work_handler(struct work_struct *work)
+{
+	struct lan865x_priv *priv = container_of(work, struct lan865x_priv,
+						 multicast_work);
+	u32 regval = 0;
+	int ret;
+
+	/* Filters and mode change together, as seen by other register users */
+	lan865x_reg_lock(priv);
+
+	if (priv->netdev->flags & IFF_PROMISC) {
+		/* Enabling promiscuous mode */
+		regval |= MAC_NET_CFG_PROMISCUOUS_MODE;
+		regval &= (~MAC_NET_CFG_MULTICAST_MODE);
+		regval &= (~MAC_NET_CFG_UNICAST_MODE);
+	} else if (priv->netdev->flags & IFF_ALLMULTI) {
+		/* Enabling all multicast mode */
+		if (__lan865x_set_all_multicast_addr(priv))
+			goto unlock;
 
 		regval &= (~MAC_NET_CFG_PROMISCUOUS_MODE);
 		regval |= MAC_NET_CFG_MULTICAST_MODE;
 		regval &= (~MAC_NET_CFG_UNICAST_MODE);
 	} else if (!netdev_mc_empty(priv->netdev)) {
 		/* Enabling specific multicast mode */
-		if (lan865x_set_specific_multicast_addr(priv))
-			return;
+		if (__lan865x_set_specific_multicast_addr(priv))
+			goto unlock;
 
 		regval &= (~MAC_NET_CFG_PROMISCUOUS_MODE);
 		regval |= MAC_NET_CFG_MULTICAST_MODE;
 		regval &= (~MAC_NET_CFG_UNICAST_MODE);
 	} else {
 		/* Enabling local mac address only */
-		if (lan865x_clear_all_multicast_addr(priv))
-			return;
+		if (__lan865x_clear_all_multicast_addr(priv))
+			goto unlock;
 	}
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_NET_CFG, regval);
+	/* Only the filter mode bits are ours, keep the rest of NET_CFG */
+	ret = __lan865x_modify_reg(priv, LAN865X_REG_MAC_NET_CFG,
+				   MAC_NET_CFG_PROMISCUOUS_MODE |
+				   MAC_NET_CFG_MULTICAST_MODE |
+				   MAC_NET_CFG_UNICAST_MODE, regval);
 	if (ret)
 		netdev_err(priv->netdev, "Failed to enable promiscuous/multicast/normal mode: %d\n",
 			   ret);
+
+unlock:
+	lan865x_reg_unlock(priv);
+}
+
+static void lan865x_set_multicast_list(struct net_device *netdev)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+
+	schedule_work(&priv->multicast_work);
 }
 
-static void lan865x_set_multicast_list(struct net_device *netdev)
-{
-	struct lan865x_priv *priv = netdev_priv(netdev);
+/* Consecutive registers read with one control transaction */
+struct lan865x_reg_block {
+	u32 addr;
+	u8 count;
+};
+
+struct lan865x_region_layout {
+	const struct lan865x_reg_block *blocks;
+	unsigned int n_blocks;
+};
+
+/* Side effect free registers only: the Clause 22 MMD indirect access
+ * registers are left out of MMS 0.
+ */
+static const struct lan865x_reg_block lan865x_mms0_blocks[] = {
+	{ 0x00000000, 0x16 },	/* OA_ID .. TTSCCL */
+	{ 0x0000ff00, 0x04 },	/* BASIC_CONTROL .. PHY_ID2 */
+};
+
+static const struct lan865x_reg_block lan865x_mms1_blocks[] = {
+	{ 0x00010000, 0x02 },	/* MAC_NCR, MAC_NCFGR */
+	{ 0x00010020, 0x0e },	/* MAC_HRB .. MAC_TIDM4 */
+	{ 0x00010032, 0x02 },	/* MAC_SAMB1, MAC_SAMT1 */
+	{ 0x0001006f, 0x09 },	/* MAC_TISUBN .. MAC_TI */
+	{ 0x00010200, 0x01 },	/* BMGR_CTL */
+	{ 0x00010208, 0x0d },	/* STATS0 .. STATS12 */
+};
+
+static const struct lan865x_region_layout lan865x_region_layouts[] = {
+	[LAN865X_REGION_MMS0] = {
+		.blocks = lan865x_mms0_blocks,
+		.n_blocks = ARRAY_SIZE(lan865x_mms0_blocks),
+	},
+	[LAN865X_REGION_MMS1] = {
+		.blocks = lan865x_mms1_blocks,
+		.n_blocks = ARRAY_SIZE(lan865x_mms1_blocks),
+	},
+};
+
+static const char * const lan865x_snapshot_reasons[] = {
+	[LAN865X_SNAPSHOT_STATUS0]	= "status0",
+	[LAN865X_SNAPSHOT_STATUS1]	= "status1",
+	[LAN865X_SNAPSHOT_TX_TIMEOUT]	= "tx_timeout",
+	[LAN865X_SNAPSHOT_NETDEV_ERRORS]	= "netdev_errors",
+};
+
+/* Bytes covered by a region: its blocks read back to back */
+static unsigned int lan865x_region_size(const struct lan865x_region_layout *layout)
+{
+	unsigned int count = 0;
+
+	for (unsigned int i = 0; i < layout->n_blocks; i++)
+		count += layout->blocks[i].count;
+
+	return count * sizeof(u32);
+}
+
+static int __lan865x_region_read(struct lan865x_priv *priv,
+				 const struct lan865x_region_layout *layout,
+				 u8 *data)
+{
+	u32 *regs = (u32 *)data;
+	int ret;
+
+	for (unsigned int i = 0; i < layout->n_blocks; i++) {
+		ret = __lan865x_read_regs(priv, layout->blocks[i].addr, regs,
+					  layout->blocks[i].count);
+		if (ret)
+			return ret;
+		regs += layout->blocks[i].count;
+	}
+
+	return 0;
+}
+
+/* On demand snapshot: devlink region new <dev>/<region> */
+static int lan865x_region_snapshot(struct devlink *devlink,
+				   const struct devlink_region_ops *ops,
+				   struct netlink_ext_ack *extack, u8 **data)
+{
+	struct lan865x_priv *priv = *(struct lan865x_priv **)devlink_priv(devlink);
+	const struct lan865x_region_layout *layout = ops->priv;
+	u8 *buf;
+	int ret;
+
+	buf = kmalloc(lan865x_region_size(layout), GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_region_read(priv, layout, buf);
+	lan865x_reg_unlock(priv);
+	if (ret) {
+		NL_SET_ERR_MSG_MOD(extack, "Failed to read registers");
+		kfree(buf);
+		return ret;
+	}
+
+	*data = buf;
+
+	return 0;
+}
+
+static const struct devlink_region_ops lan865x_region_ops[] = {
+	[LAN865X_REGION_MMS0] = {
+		.name = "mms0",
+		.destructor = kfree,
+		.snapshot = lan865x_region_snapshot,
+		.priv = (void *)&lan865x_region_layouts[LAN865X_REGION_MMS0],
+	},
+	[LAN865X_REGION_MMS1] = {
+		.name = "mms1",
+		.destructor = kfree,
+		.snapshot = lan865x_region_snapshot,
+		.priv = (void *)&lan865x_region_layouts[LAN865X_REGION_MMS1],
+	},
+};
+
+static const struct devlink_ops lan865x_devlink_ops = {
+};
+
+static int lan865x_snapshot_take(struct lan865x_priv *priv, u32 *id)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+	int ret, i;
+
+	for (i = 0; i < LAN865X_REGION_COUNT; i++) {
+		if (!snap->bufs[i])
+			return -ENOMEM;
+	}
+
+	/* Capture both register spaces back to back before anything else */
+	lan865x_reg_lock(priv);
+	for (i = 0; i < LAN865X_REGION_COUNT; i++) {
+		ret = __lan865x_region_read(priv, &lan865x_region_layouts[i],
+					    snap->bufs[i]);
+		if (ret)
+			break;
+	}
+	lan865x_reg_unlock(priv);
+	if (ret)
+		return ret;
+
+	ret = devlink_region_snapshot_id_get(snap->devlink, id);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < LAN865X_REGION_COUNT; i++) {
+		ret = devlink_region_snapshot_create(snap->regions[i],
+						     snap->bufs[i], *id);
+		if (ret)
+			break;
+		/* Owned by devlink now */
+		snap->bufs[i] = NULL;
+	}
+
+	devlink_region_snapshot_id_put(snap->devlink, *id);
+
+	return ret;
+}
+
+static void lan865x_snapshot_work_handler(struct work_struct *work)
+{
+	struct lan865x_snapshot *snap = container_of(work,
+						     struct lan865x_snapshot,
+						     work);
+	struct lan865x_priv *priv = container_of(snap, struct lan865x_priv,
+						 snapshot);
+	unsigned long reasons = xchg(&snap->reasons, 0);
+	u32 status1;
+	u32 id;
+	int ret;
+
+	ret = lan865x_snapshot_take(priv, &id);
+
+	/* Sticky, so re-arm them for the next event only after the capture */
+	status1 = atomic_xchg(&snap->status1_clear, 0);
+	if (status1)
+		lan865x_write_reg(priv, LAN865X_REG_OA_STATUS1, status1);
+
+	if (ret) {
+		snap->failed++;
+		netdev_warn(priv->netdev, "Register snapshot failed: %d\n", ret);
+	} else {
+		snap->taken++;
+		snap->last_id = id;
+		snap->last_reasons = reasons;
+		netdev_info(priv->netdev,
+			    "Register snapshot %u taken (reasons 0x%lx)\n",
+			    id, reasons);
+	}
+
+	/* Refill for the next capture */
+	for (int i = 0; i < LAN865X_REGION_COUNT; i++) {
+		if (!snap->bufs[i])
+			snap->bufs[i] = kmalloc(lan865x_region_size(&lan865x_region_layouts[i]),
+						GFP_KERNEL);
+	}
+}
+
+/* Callable from any context with a mask of lan865x_snapshot_reason bits;
+ * the capture itself runs from a work item.
+ */
+static bool lan865x_snapshot_trigger(struct lan865x_priv *priv,
+				     unsigned long reasons)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+	unsigned int i;
+
+	if (!__ratelimit(&snap->ratelimit)) {
+		atomic_inc(&snap->rate_limited);
+		return false;
+	}
+
+	for_each_set_bit(i, &reasons, BITS_PER_LONG)
+		set_bit(i, &snap->reasons);
+	schedule_work(&snap->work);
+
+	return true;
+}
+
+/* oa_tc6 write-1-clears OA_STATUS0 as soon as a footer flags it, so a
+ * telemetry sample only catches an error bit by chance. Still use it when
+ * it does.
+ */
+static void lan865x_snapshot_check_status(struct lan865x_priv *priv,
+					  u32 status0)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+	u32 new0 = status0 & ~snap->status0 & OA_STATUS0_ERRORS;
+
+	snap->status0 = status0;
+
+	if (new0)
+		lan865x_snapshot_trigger(priv, BIT(LAN865X_SNAPSHOT_STATUS0));
+}
+
+/* Error counters oa_tc6 bumps when it handles OA_STATUS0 errors itself,
+ * e.g. RX buffer overflows and aborted frames.
+ */
+static unsigned long lan865x_netdev_errors(struct net_device *netdev)
+{
+	return READ_ONCE(netdev->stats.rx_dropped) +
+	       READ_ONCE(netdev->stats.rx_errors) +
+	       READ_ONCE(netdev->stats.tx_dropped) +
+	       READ_ONCE(netdev->stats.tx_errors);
+}
+
+static void lan865x_snapshot_watch_handler(struct work_struct *work)
+{
+	struct lan865x_snapshot *snap = container_of(to_delayed_work(work),
+						     struct lan865x_snapshot,
+						     watch);
+	struct lan865x_priv *priv = container_of(snap, struct lan865x_priv,
+						 snapshot);
+	unsigned long errors = lan865x_netdev_errors(priv->netdev);
+	unsigned long reasons = 0;
+	u32 status1;
+
+	if (errors != snap->netdev_errors)
+		reasons |= BIT(LAN865X_SNAPSHOT_NETDEV_ERRORS);
+	snap->netdev_errors = errors;
+
+	/* oa_tc6 leaves OA_STATUS1 alone, its error bits stay set until
+	 * cleared here.
+	 */
+	if (lan865x_read_regs(priv, LAN865X_REG_OA_STATUS1, &status1, 1))
+		status1 = 0;
+	else
+		snap->status1 = status1;
+	status1 &= OA_STATUS1_ERRORS;
+	if (status1) {
+		reasons |= BIT(LAN865X_SNAPSHOT_STATUS1);
+		atomic_or(status1, &snap->status1_clear);
+	}
+
+	/* Without a capture to wait for, re-arm the error bits right away */
+	if (reasons && !lan865x_snapshot_trigger(priv, reasons)) {
+		status1 = atomic_xchg(&snap->status1_clear, 0);
+		if (status1)
+			lan865x_write_reg(priv, LAN865X_REG_OA_STATUS1,
+					  status1);
+	}
+
+	schedule_delayed_work(&snap->watch, LAN865X_SNAPSHOT_WATCH);
+}
+
+static void lan865x_snapshot_watch_start(struct lan865x_priv *priv)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+
+	snap->netdev_errors = lan865x_netdev_errors(priv->netdev);
+	schedule_delayed_work(&snap->watch, LAN865X_SNAPSHOT_WATCH);
+}
+
+static void lan865x_snapshot_watch_stop(struct lan865x_priv *priv)
+{
+	cancel_delayed_work_sync(&priv->snapshot.watch);
+}
+
+static int lan865x_snapshot_init(struct lan865x_priv *priv)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+	struct devlink_region *region;
+	int ret, i;
+
+	INIT_WORK(&snap->work, lan865x_snapshot_work_handler);
+	INIT_DELAYED_WORK(&snap->watch, lan865x_snapshot_watch_handler);
+	ratelimit_state_init(&snap->ratelimit, LAN865X_SNAPSHOT_INTERVAL, 1);
+	ratelimit_set_flags(&snap->ratelimit, RATELIMIT_MSG_ON_RELEASE);
+
+	snap->devlink = devlink_alloc(&lan865x_devlink_ops,
+				      sizeof(struct lan865x_priv *),
+				      &priv->spi->dev);
+	if (!snap->devlink)
+		return -ENOMEM;
+	*(struct lan865x_priv **)devlink_priv(snap->devlink) = priv;
+
+	for (i = 0; i < LAN865X_REGION_COUNT; i++) {
+		region = devlink_region_create(snap->devlink,
+					       &lan865x_region_ops[i],
+					       LAN865X_SNAPSHOT_MAX,
+					       lan865x_region_size(&lan865x_region_layouts[i]));
+		if (IS_ERR(region)) {
+			ret = PTR_ERR(region);
+			goto err_destroy;
+		}
+		snap->regions[i] = region;
+
+		snap->bufs[i] = kmalloc(lan865x_region_size(&lan865x_region_layouts[i]),
+					GFP_KERNEL);
+		if (!snap->bufs[i]) {
+			ret = -ENOMEM;
+			i++;
+			goto err_destroy;
+		}
+	}
+
+	return 0;
+
+err_destroy:
+	while (i--) {
+		kfree(snap->bufs[i]);
+		devlink_region_destroy(snap->regions[i]);
+	}
+	devlink_free(snap->devlink);
+	return ret;
+}
+
+static void lan865x_snapshot_exit(struct lan865x_priv *priv)
+{
+	struct lan865x_snapshot *snap = &priv->snapshot;
+
+	cancel_delayed_work_sync(&snap->watch);
+	cancel_work_sync(&snap->work);
+	for (int i = 0; i < LAN865X_REGION_COUNT; i++) {
+		kfree(snap->bufs[i]);
+		devlink_region_destroy(snap->regions[i]);
+	}
+	devlink_free(snap->devlink);
+}
+
+/* The PLCA configuration lives in the PHY and is changed through the
+ * ethtool PLCA interface of phylib, so it is re-read now and then.
+ */
+static void lan865x_plca_refresh(struct lan865x_priv *priv)
+{
+	struct phy_device *phydev = priv->netdev->phydev;
+	struct phy_plca_cfg cfg = { };
+	unsigned int burst_frames = 0;
+	int ret;
+
+	if (!phydev)
+		goto out;
+
+	ret = phy_ethtool_get_plca_cfg(phydev, &cfg);
+	if (!ret && cfg.enabled > 0)
+		burst_frames = 1 + max(cfg.burst_cnt, 0);
+
+out:
+	WRITE_ONCE(priv->plca.burst_frames, burst_frames);
+}
+
+static void lan865x_plca_sample(struct lan865x_priv *priv, u8 txc)
+{
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+	struct lan865x_plca *plca = &priv->plca;
+	unsigned int staging, staged;
+	struct lan865x_sw_stats sw;
+	u64 packets;
+
+	if (!plca->refresh--) {
+		lan865x_plca_refresh(priv);
+		plca->refresh = LAN865X_PLCA_REFRESH_SAMPLES;
+	}
+
+	if (!plca->burst_frames) {
+		bufsts->stop_limit = LAN865X_TXC_STOP_THRESH_MAX;
+		return;
+	}
+
+	/* Credits per frame from the frame sizes sent since the last sample */
+	lan865x_get_sw_stats(priv, &sw);
+	packets = sw.tx_packets - plca->last_packets;
+	if (packets)
+		plca->frame_credits =
+			DIV_ROUND_UP_ULL(div64_u64(sw.tx_bytes - plca->last_bytes,
+						   packets),
+					 LAN865X_CHUNK_PAYLOAD);
+	plca->frame_credits = max(plca->frame_credits, 1U);
+	plca->last_packets = sw.tx_packets;
+	plca->last_bytes = sw.tx_bytes;
+
+	/* Never stop the queue before a whole burst can be staged */
+	staging = plca->burst_frames * plca->frame_credits;
+	bufsts->stop_limit = bufsts->txc_max > staging ?
+			     min_t(unsigned int, bufsts->txc_max - staging,
+				   LAN865X_TXC_STOP_THRESH_MAX) : 0;
+
+	staged = (bufsts->txc_max - txc) / plca->frame_credits;
+
+	u64_stats_update_begin(&plca->syncp);
+	u64_stats_inc(&plca->samples);
+	if (!staged)
+		u64_stats_inc(&plca->empty);
+	else if (staged < plca->burst_frames)
+		u64_stats_inc(&plca->burst_partial);
+	else
+		u64_stats_inc(&plca->burst_full);
+	u64_stats_update_end(&plca->syncp);
+}
+
+/* Adapt the TX credit threshold at which the netdev queue is stopped. A TX
+ * buffer underflow means the MAC-PHY ran dry, so let more frames be staged
+ * before stopping; an exhausted TX buffer means frames pile up inside the
+ * MAC-PHY, so stop the queue earlier.
+ */
+static void lan865x_bufsts_adapt(struct lan865x_bufsts *bufsts, u8 txc,
+				 bool txbue)
+{
+	u8 stop_thresh = bufsts->stop_thresh;
+
+	if (txbue && !bufsts->txbue) {
+		if (stop_thresh)
+			stop_thresh--;
+	} else if (!txc && stop_thresh < LAN865X_TXC_STOP_THRESH_MAX) {
+		stop_thresh++;
+	}
+	stop_thresh = min(stop_thresh, bufsts->stop_limit);
+
+	WRITE_ONCE(bufsts->stop_thresh, stop_thresh);
+	WRITE_ONCE(bufsts->wake_thresh, stop_thresh + LAN865X_TXC_HYSTERESIS);
+}
+
+/* Queue wakes from process context must not nest inside a transmit on the
+ * same CPU, or the per-CPU sequence counter could be torn.
+ */
+static void lan865x_bufsts_wake_queue(struct lan865x_priv *priv)
+{
+	struct lan865x_pcpu_stats *stats;
+
+	WRITE_ONCE(priv->bufsts.queue_stopped, false);
+	netif_wake_queue(priv->netdev);
+
+	local_bh_disable();
+	stats = this_cpu_ptr(priv->stats);
+	u64_stats_update_begin(&stats->syncp);
+	u64_stats_inc(&stats->tx_queue_wake);
+	u64_stats_update_end(&stats->syncp);
+	local_bh_enable();
+}
+
+static int lan865x_bufsts_sample(struct lan865x_priv *priv, bool periodic)
+{
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+	u32 regs[LAN865X_BUFSTS_SAMPLE_REGS];
+	bool txbue;
+	u8 txc, rba;
+	int ret;
+
+	mutex_lock(&bufsts->lock);
+
+	/* Lockless, see lan865x_reg_lock() */
+	ret = oa_tc6_read_registers(priv->tc6, LAN865X_REG_OA_STATUS0, regs,
+				    LAN865X_BUFSTS_SAMPLE_REGS);
+	if (ret)
+		goto unlock;
+
+	WRITE_ONCE(bufsts->sampled_at, ktime_get());
+	lan865x_snapshot_check_status(priv, regs[0]);
+
+	txc = FIELD_GET(OA_BUFSTS_TXC, regs[3]);
+	rba = FIELD_GET(OA_BUFSTS_RBA, regs[3]);
+	txbue = regs[0] & OA_STATUS0_TXBUE;
+
+	bufsts->samples++;
+	bufsts->txc_hist[min_t(u8, txc, LAN865X_BUFSTS_BUCKETS - 1)]++;
+	bufsts->rba_hist[min_t(u8, rba, LAN865X_BUFSTS_BUCKETS - 1)]++;
+	if (txbue && !bufsts->txbue)
+		bufsts->txbue_events++;
+
+	/* Only adapt at the telemetry rate, not while polling a held queue */
+	if (periodic && READ_ONCE(bufsts->adaptive))
+		lan865x_bufsts_adapt(bufsts, txc, txbue);
+
+	bufsts->txbue = txbue;
+	bufsts->txc_max = max(bufsts->txc_max, txc);
+	WRITE_ONCE(bufsts->txc, txc);
+
+	if (periodic)
+		lan865x_plca_sample(priv, txc);
+
+	/* An empty TX buffer always wakes the queue, whatever its size */
+	if (READ_ONCE(bufsts->queue_stopped) &&
+	    txc >= min(READ_ONCE(bufsts->wake_thresh), bufsts->txc_max))
+		lan865x_bufsts_wake_queue(priv);
+
+unlock:
+	mutex_unlock(&bufsts->lock);
+
+	return ret;
+}
+
+static void lan865x_bufsts_work_handler(struct work_struct *work)
+{
+	struct lan865x_bufsts *bufsts = container_of(to_delayed_work(work),
+						     struct lan865x_bufsts,
+						     work);
+	struct lan865x_priv *priv = container_of(bufsts, struct lan865x_priv,
+						 bufsts);
+	u32 interval_ms;
+
+	lan865x_bufsts_sample(priv, true);
+
+	interval_ms = READ_ONCE(bufsts->interval_ms);
+	if (interval_ms && READ_ONCE(bufsts->running))
+		schedule_delayed_work(&bufsts->work,
+				      msecs_to_jiffies(interval_ms));
+}
+
+/* A held queue is only released from here. Never hold it on stale credit
+ * information, nor for long when credits do not come back (link down, no
+ * PLCA beacon); oa_tc6 still flow controls by itself.
+ */
+static void lan865x_bufsts_poll_handler(struct work_struct *work)
+{
+	struct lan865x_bufsts *bufsts = container_of(work,
+						     struct lan865x_bufsts,
+						     poll);
+	struct lan865x_priv *priv = container_of(bufsts, struct lan865x_priv,
+						 bufsts);
+	int ret;
+
+	ret = lan865x_bufsts_sample(priv, false);
+
+	if (!READ_ONCE(bufsts->queue_stopped))
+		return;
+
+	if (ret || !READ_ONCE(bufsts->running) ||
+	    ktime_after(ktime_get(), bufsts->hold_until))
+		lan865x_bufsts_wake_queue(priv);
+	else
+		hrtimer_start(&bufsts->timer,
+			      us_to_ktime(LAN865X_BUFSTS_HOLD_POLL_US),
+			      HRTIMER_MODE_REL);
+}
+
+/* SPI reads sleep, so the timer only kicks the poll */
+static enum hrtimer_restart lan865x_bufsts_timer(struct hrtimer *timer)
+{
+	struct lan865x_bufsts *bufsts = container_of(timer,
+						     struct lan865x_bufsts,
+						     timer);
+
+	queue_work(system_highpri_wq, &bufsts->poll);
+
+	return HRTIMER_NORESTART;
+}
+
+static void lan865x_bufsts_start(struct lan865x_priv *priv)
+{
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+
+	WRITE_ONCE(bufsts->queue_stopped, false);
+	WRITE_ONCE(bufsts->txc, 0);
+	WRITE_ONCE(bufsts->sampled_at, 0);
+	bufsts->txbue = false;
+	/* Pick up PLCA changes made while the interface was down */
+	priv->plca.refresh = 0;
+	WRITE_ONCE(bufsts->running, true);
+
+	if (READ_ONCE(bufsts->interval_ms))
+		schedule_delayed_work(&bufsts->work, 0);
+}
+
+static void lan865x_bufsts_stop(struct lan865x_priv *priv)
+{
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+
+	WRITE_ONCE(bufsts->running, false);
+	cancel_delayed_work_sync(&bufsts->work);
+	hrtimer_cancel(&bufsts->timer);
+	cancel_work_sync(&bufsts->poll);
+	/* The poll may have re-armed the timer before it saw !running */
+	hrtimer_cancel(&bufsts->timer);
+	WRITE_ONCE(bufsts->queue_stopped, false);
+}
+
+static netdev_tx_t lan865x_send_packet(struct sk_buff *skb,
+				       struct net_device *netdev)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	struct lan865x_pcpu_stats *stats = this_cpu_ptr(priv->stats);
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+	unsigned int len = skb->len;
+	bool queue_stop = false;
+	bool queue_wake = false;
+	bool dropped = false;
+	bool held = false;
+	netdev_tx_t ret;
+
+	if (unlikely(test_bit(LAN865X_PM_FIRST_XMIT, &priv->pm.flags)) &&
+	    test_and_clear_bit(LAN865X_PM_FIRST_XMIT, &priv->pm.flags))
+		WRITE_ONCE(priv->pm.first_xmit_us,
+			   ktime_us_delta(ktime_get(), priv->pm.resume_start));
+
+	/* Being called again after a busy return means oa_tc6 woke the queue */
+	if (priv->tx_busy_stopped) {
+		priv->tx_busy_stopped = false;
+		queue_wake = true;
+	}
+
+	/* oa_tc6 wakes the queue after every SPI transfer, so a plain stop
+	 * does not hold it. Hand the frame back until the hold poll releases
+	 * the queue; the stack retries once it is woken.
+	 */
+	if (unlikely(READ_ONCE(bufsts->queue_stopped))) {
+		netif_stop_queue(netdev);
+		/* Pairs with the wake in lan865x_bufsts_wake_queue() */
+		smp_mb__after_atomic();
+		if (READ_ONCE(bufsts->queue_stopped)) {
+			/* The transfer behind this wake sent TX chunks, so
+			 * re-sample now instead of waiting for the timer.
+			 */
+			queue_work(system_highpri_wq, &bufsts->poll);
+			held = true;
+			ret = NETDEV_TX_BUSY;
+			goto update_stats;
+		}
+		netif_start_queue(netdev);
+	}
+
+	/* oa_tc6_start_xmit() would linearize and drop the same way, but the
+	 * drop would not show up in our own counters.
+	 */
+	if (unlikely(skb_linearize(skb))) {
+		dev_kfree_skb_any(skb);
+		dropped = true;
+		ret = NETDEV_TX_OK;
+		goto update_stats;
+	}
+
+	ret = oa_tc6_start_xmit(priv->tc6, skb);
+	if (ret != NETDEV_TX_OK) {
+		/* oa_tc6 has stopped the queue and wakes it on its own */
+		priv->tx_busy_stopped = true;
+		goto update_stats;
+	}
+
+	/* Keep the MAC-PHY TX buffer just full enough; the hold poll
+	 * releases the queue once enough TX credits are available again.
+	 * Decide only on a fresh sample, otherwise ask for one.
+	 */
+	if (READ_ONCE(bufsts->adaptive) && READ_ONCE(bufsts->running)) {
+		if (ktime_us_delta(ktime_get(), READ_ONCE(bufsts->sampled_at)) >
+		    LAN865X_BUFSTS_FRESH_US) {
+			queue_work(system_highpri_wq, &bufsts->poll);
+		} else if (READ_ONCE(bufsts->txc) <
+			   READ_ONCE(bufsts->stop_thresh)) {
+			bufsts->hold_until =
+				ktime_add_ms(ktime_get(),
+					     LAN865X_BUFSTS_HOLD_MAX_MS);
+			WRITE_ONCE(bufsts->queue_stopped, true);
+			netif_stop_queue(netdev);
+			queue_stop = true;
+			queue_work(system_highpri_wq, &bufsts->poll);
+		}
+	}
+
+update_stats:
+	u64_stats_update_begin(&stats->syncp);
+	if (dropped) {
+		u64_stats_inc(&stats->tx_dropped);
+	} else if (ret == NETDEV_TX_OK) {
+		u64_stats_inc(&stats->tx_packets);
+		u64_stats_add(&stats->tx_bytes, len);
+	} else if (!held) {
+		/* A held queue was counted when the hold was taken */
+		u64_stats_inc(&stats->tx_busy);
+		u64_stats_inc(&stats->tx_queue_stop);
+	}
+	if (queue_stop)
+		u64_stats_inc(&stats->tx_queue_stop);
+	if (queue_wake)
+		u64_stats_inc(&stats->tx_queue_wake);
+	u64_stats_update_end(&stats->syncp);
+
+	return ret;
+}
+
+static void lan865x_get_stats64(struct net_device *netdev,
+				struct rtnl_link_stats64 *storage)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	struct lan865x_sw_stats sw;
+
+	/* Completed frames and RX are accounted by oa_tc6 in netdev->stats */
+	netdev_stats_to_stats64(storage, &netdev->stats);
+
+	lan865x_get_sw_stats(priv, &sw);
+	storage->tx_dropped += sw.tx_dropped;
+}
+
+static void lan865x_tx_timeout(struct net_device *netdev, unsigned int txqueue)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+
+	netdev_warn(netdev, "Transmit timeout, taking register snapshot\n");
+	lan865x_snapshot_trigger(priv, BIT(LAN865X_SNAPSHOT_TX_TIMEOUT));
+}
+
+static int lan865x_hw_disable(struct lan865x_priv *priv)
+{
+	if (lan865x_modify_reg(priv, LAN865X_REG_MAC_NET_CTL,
+			       MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN, 0))
+		return -ENODEV;
+
+	return 0;
+}
+
+static int lan865x_net_close(struct net_device *netdev)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	int ret;
+
+	lan865x_snapshot_watch_stop(priv);
+	lan865x_coal_stop(priv);
+	lan865x_bufsts_stop(priv);
+	netif_stop_queue(netdev);
+	phy_stop(netdev->phydev);
+	ret = lan865x_hw_disable(priv);
+	if (ret)
+		netdev_err(netdev, "Failed to disable the hardware: %d\n", ret);
+
+	pm_runtime_put(&priv->spi->dev);
+
+	return ret;
+}
+
+static int lan865x_hw_enable(struct lan865x_priv *priv)
+{
+	if (lan865x_modify_reg(priv, LAN865X_REG_MAC_NET_CTL,
+			       MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN,
+			       MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN))
+		return -ENODEV;
+
+	return 0;
+}
+
+static int lan865x_net_open(struct net_device *netdev)
+{
+	struct lan865x_priv *priv = netdev_priv(netdev);
+	int ret;
+
+	ret = pm_runtime_resume_and_get(&priv->spi->dev);
+	if (ret)
+		return ret;
+
+	ret = lan865x_hw_enable(priv);
+	if (ret) {
+		netdev_err(netdev, "Failed to enable hardware: %d\n", ret);
+		pm_runtime_put(&priv->spi->dev);
+		return ret;
+	}
+
+	phy_start(netdev->phydev);
+
+	netif_start_queue(netdev);
+
+	lan865x_bufsts_start(priv);
+	lan865x_coal_start(priv);
+	lan865x_snapshot_watch_start(priv);
+
+	return 0;
+}
+
+static const struct net_device_ops lan865x_netdev_ops = {
+	.ndo_open		= lan865x_net_open,
+	.ndo_stop		= lan865x_net_close,
+	.ndo_start_xmit		= lan865x_send_packet,
+	.ndo_tx_timeout		= lan865x_tx_timeout,
+	.ndo_set_rx_mode	= lan865x_set_multicast_list,
+	.ndo_set_mac_address	= lan865x_set_mac_address,
+	.ndo_get_stats64	= lan865x_get_stats64,
+};
+
+static struct genl_family lan865x_genl_family;
 
-	schedule_work(&priv->multicast_work);
-}
+static const struct nla_policy lan865x_nl_reg_policy[LAN865X_REG_ATTR_MAX + 1] = {
+	[LAN865X_REG_ATTR_ADDR] = { .type = NLA_U32 },
+	[LAN865X_REG_ATTR_COUNT] = NLA_POLICY_RANGE(NLA_U32, 1,
+						    LAN865X_NL_MAX_BLOCK_REGS),
+	[LAN865X_REG_ATTR_VALUES] = { .type = NLA_BINARY,
+				      .len = LAN865X_NL_MAX_BLOCK_REGS *
+					     sizeof(u32) },
+};
 
-static netdev_tx_t lan865x_send_packet(struct sk_buff *skb,
-				       struct net_device *netdev)
-{
-	struct lan865x_priv *priv = netdev_priv(netdev);
+static const struct nla_policy lan865x_nl_policy[LAN865X_ATTR_MAX + 1] = {
+	[LAN865X_ATTR_IFINDEX] = { .type = NLA_U32 },
+	[LAN865X_ATTR_REG] = NLA_POLICY_NESTED(lan865x_nl_reg_policy),
+};
 
-	return oa_tc6_start_xmit(priv->tc6, skb);
-}
+#define lan865x_nl_for_each_reg(nla, info, rem)				\
+	nla_for_each_attr_type(nla, LAN865X_ATTR_REG,			\
+			       genlmsg_data((info)->genlhdr),		\
+			       genlmsg_len((info)->genlhdr), rem)
 
-static int lan865x_hw_disable(struct lan865x_priv *priv)
+/* Look up the target device; the caller must dev_put() it */
+static struct lan865x_priv *lan865x_nl_get_priv(struct genl_info *info)
 {
-	u32 regval;
+	struct net_device *netdev;
 
-	if (oa_tc6_read_register(priv->tc6, LAN865X_REG_MAC_NET_CTL, &regval))
-		return -ENODEV;
+	if (GENL_REQ_ATTR_CHECK(info, LAN865X_ATTR_IFINDEX))
+		return ERR_PTR(-EINVAL);
 
-	regval &= ~(MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN);
+	netdev = dev_get_by_index(genl_info_net(info),
+				  nla_get_u32(info->attrs[LAN865X_ATTR_IFINDEX]));
+	if (!netdev) {
+		NL_SET_BAD_ATTR(info->extack, info->attrs[LAN865X_ATTR_IFINDEX]);
+		return ERR_PTR(-ENODEV);
+	}
 
-	if (oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_NET_CTL, regval))
-		return -ENODEV;
+	if (netdev->netdev_ops != &lan865x_netdev_ops) {
+		NL_SET_ERR_MSG(info->extack, "Not a LAN865x device");
+		dev_put(netdev);
+		return ERR_PTR(-EOPNOTSUPP);
+	}
 
-	return 0;
+	if (!((struct lan865x_priv *)netdev_priv(netdev))->debug_enabled) {
+		NL_SET_ERR_MSG(info->extack, "Register access disabled");
+		dev_put(netdev);
+		return ERR_PTR(-EPERM);
+	}
+
+	return netdev_priv(netdev);
 }
 
-static int lan865x_net_close(struct net_device *netdev)
+/* Parse one register block; count comes from COUNT or the VALUES length */
+static int lan865x_nl_parse_reg(struct nlattr *nla, bool write,
+				struct nlattr **tb, u32 *addr, u32 *count,
+				struct netlink_ext_ack *extack)
 {
-	struct lan865x_priv *priv = netdev_priv(netdev);
 	int ret;
 
-	netif_stop_queue(netdev);
-	phy_stop(netdev->phydev);
-	ret = lan865x_hw_disable(priv);
-	if (ret) {
-		netdev_err(netdev, "Failed to disable the hardware: %d\n", ret);
+	ret = nla_parse_nested(tb, LAN865X_REG_ATTR_MAX, nla,
+			       lan865x_nl_reg_policy, extack);
+	if (ret)
 		return ret;
+
+	if (!tb[LAN865X_REG_ATTR_ADDR]) {
+		NL_SET_ERR_MSG_ATTR(extack, nla, "Missing register address");
+		return -EINVAL;
 	}
+	*addr = nla_get_u32(tb[LAN865X_REG_ATTR_ADDR]);
+
+	if (!write) {
+		*count = tb[LAN865X_REG_ATTR_COUNT] ?
+			 nla_get_u32(tb[LAN865X_REG_ATTR_COUNT]) : 1;
+		return 0;
+	}
+
+	if (!tb[LAN865X_REG_ATTR_VALUES] ||
+	    !nla_len(tb[LAN865X_REG_ATTR_VALUES]) ||
+	    nla_len(tb[LAN865X_REG_ATTR_VALUES]) % sizeof(u32)) {
+		NL_SET_ERR_MSG_ATTR(extack, nla, "Invalid register values");
+		return -EINVAL;
+	}
+	*count = nla_len(tb[LAN865X_REG_ATTR_VALUES]) / sizeof(u32);
 
 	return 0;
 }
 
-static int lan865x_hw_enable(struct lan865x_priv *priv)
+/* Validate all blocks before touching the hardware and size the reply */
+static int lan865x_nl_check_regs(struct genl_info *info, bool write,
+				 size_t *reply_size)
 {
-	u32 regval;
+	struct nlattr *tb[LAN865X_REG_ATTR_MAX + 1];
+	u32 total = 0, addr, count;
+	struct nlattr *nla;
+	int rem, ret;
 
-	if (oa_tc6_read_register(priv->tc6, LAN865X_REG_MAC_NET_CTL, &regval))
-		return -ENODEV;
+	*reply_size = nla_total_size(sizeof(u32));
 
-	regval |= MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN;
+	lan865x_nl_for_each_reg(nla, info, rem) {
+		ret = lan865x_nl_parse_reg(nla, write, tb, &addr, &count,
+					   info->extack);
+		if (ret)
+			return ret;
 
-	if (oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_NET_CTL, regval))
-		return -ENODEV;
+		total += count;
+		if (total > LAN865X_NL_MAX_MSG_REGS) {
+			NL_SET_ERR_MSG_ATTR(info->extack, nla,
+					    "Too many registers in one message");
+			return -E2BIG;
+		}
+
+		*reply_size += nla_total_size(nla_total_size(sizeof(u32)) +
+					      nla_total_size(count * sizeof(u32)));
+	}
+
+	if (!total) {
+		NL_SET_ERR_MSG(info->extack, "No register blocks");
+		return -EINVAL;
+	}
 
 	return 0;
 }
 
-static int lan865x_net_open(struct net_device *netdev)
+static int lan865x_nl_reg_read(struct sk_buff *skb, struct genl_info *info)
 {
-	struct lan865x_priv *priv = netdev_priv(netdev);
-	int ret;
+	struct nlattr *tb[LAN865X_REG_ATTR_MAX + 1];
+	struct nlattr *nla, *nest, *values;
+	struct lan865x_priv *priv;
+	struct sk_buff *msg;
+	size_t reply_size;
+	u32 addr, count;
+	int rem, ret;
+	void *hdr;
 
-	ret = lan865x_hw_enable(priv);
-	if (ret) {
-		netdev_err(netdev, "Failed to enable hardware: %d\n", ret);
-		return ret;
+	priv = lan865x_nl_get_priv(info);
+	if (IS_ERR(priv))
+		return PTR_ERR(priv);
+
+	ret = lan865x_nl_check_regs(info, false, &reply_size);
+	if (ret)
+		goto put_netdev;
+
+	msg = genlmsg_new(reply_size, GFP_KERNEL);
+	if (!msg) {
+		ret = -ENOMEM;
+		goto put_netdev;
 	}
 
-	phy_start(netdev->phydev);
+	hdr = genlmsg_put_reply(msg, info, &lan865x_genl_family, 0,
+				LAN865X_CMD_REG_READ);
+	if (!hdr ||
+	    nla_put_u32(msg, LAN865X_ATTR_IFINDEX, priv->netdev->ifindex)) {
+		ret = -EMSGSIZE;
+		goto free_msg;
+	}
 
-	netif_start_queue(netdev);
+	/* All blocks of one request are read as one atomic sequence */
+	lan865x_reg_lock(priv);
+	lan865x_nl_for_each_reg(nla, info, rem) {
+		lan865x_nl_parse_reg(nla, false, tb, &addr, &count, NULL);
 
-	return 0;
+		nest = nla_nest_start(msg, LAN865X_ATTR_REG);
+		if (!nest || nla_put_u32(msg, LAN865X_REG_ATTR_ADDR, addr)) {
+			ret = -EMSGSIZE;
+			goto unlock;
+		}
+
+		values = nla_reserve(msg, LAN865X_REG_ATTR_VALUES,
+				     count * sizeof(u32));
+		if (!values) {
+			ret = -EMSGSIZE;
+			goto unlock;
+		}
+
+		ret = __lan865x_read_regs(priv, addr, nla_data(values), count);
+		if (ret) {
+			NL_SET_ERR_MSG_FMT(info->extack,
+					   "Failed to read register 0x%08x", addr);
+			goto unlock;
+		}
+
+		nla_nest_end(msg, nest);
+	}
+	lan865x_reg_unlock(priv);
+
+	genlmsg_end(msg, hdr);
+	dev_put(priv->netdev);
+
+	return genlmsg_reply(msg, info);
+
+unlock:
+	lan865x_reg_unlock(priv);
+free_msg:
+	nlmsg_free(msg);
+put_netdev:
+	dev_put(priv->netdev);
+	return ret;
 }
 
-static const struct net_device_ops lan865x_netdev_ops = {
-	.ndo_open		= lan865x_net_open,
-	.ndo_stop		= lan865x_net_close,
-	.ndo_start_xmit		= lan865x_send_packet,
-	.ndo_set_rx_mode	= lan865x_set_multicast_list,
-	.ndo_set_mac_address	= lan865x_set_mac_address,
+static int lan865x_nl_reg_write(struct sk_buff *skb, struct genl_info *info)
+{
+	struct nlattr *tb[LAN865X_REG_ATTR_MAX + 1];
+	struct lan865x_priv *priv;
+	size_t reply_size;
+	u32 addr, count;
+	struct nlattr *nla;
+	int rem, ret;
+
+	priv = lan865x_nl_get_priv(info);
+	if (IS_ERR(priv))
+		return PTR_ERR(priv);
+
+	ret = lan865x_nl_check_regs(info, true, &reply_size);
+	if (ret)
+		goto put_netdev;
+
+	lan865x_reg_lock(priv);
+	lan865x_nl_for_each_reg(nla, info, rem) {
+		lan865x_nl_parse_reg(nla, true, tb, &addr, &count, NULL);
+
+		ret = __lan865x_write_regs(priv, addr,
+					   nla_data(tb[LAN865X_REG_ATTR_VALUES]),
+					   count);
+		if (ret) {
+			NL_SET_ERR_MSG_FMT(info->extack,
+					   "Failed to write register 0x%08x", addr);
+			break;
+		}
+	}
+	lan865x_reg_unlock(priv);
+
+put_netdev:
+	dev_put(priv->netdev);
+	return ret;
+}
+
+static const struct genl_small_ops lan865x_genl_ops[] = {
+	{
+		.cmd	= LAN865X_CMD_REG_READ,
+		.doit	= lan865x_nl_reg_read,
+		.flags	= GENL_ADMIN_PERM,
+	},
+	{
+		.cmd	= LAN865X_CMD_REG_WRITE,
+		.doit	= lan865x_nl_reg_write,
+		.flags	= GENL_ADMIN_PERM,
+	},
+};
+
+static struct genl_family lan865x_genl_family __ro_after_init = {
+	.name		= LAN865X_GENL_NAME,
+	.version	= LAN865X_GENL_VERSION,
+	.maxattr	= LAN865X_ATTR_MAX,
+	.policy		= lan865x_nl_policy,
+	.netnsok	= true,
+	.module		= THIS_MODULE,
+	.small_ops	= lan865x_genl_ops,
+	.n_small_ops	= ARRAY_SIZE(lan865x_genl_ops),
+	.resv_start_op	= LAN865X_CMD_REG_WRITE + 1,
 };
 
 /* Enhanced debugfs interface for register access with comprehensive debugging */
@@ -346,6 +2377,7 @@ static ssize_t lan865x_debugfs_reg_read(struct file *file, char __user *user_buf
 					size_t count, loff_t *ppos)
 {
 	struct lan865x_priv *priv = file->private_data;
+	u32 last_addr, last_value;
 	char buf[512];
 	int len;
 	u32 reg_val;
@@ -357,7 +2389,11 @@ static ssize_t lan865x_debugfs_reg_read(struct file *file, char __user *user_buf
 	}
 	
 	/* Read some key registers for debugging */
-	ret = oa_tc6_read_register(priv->tc6, LAN865X_REG_MAC_NET_CTL, &reg_val);
+	lan865x_reg_lock(priv);
+	ret = __lan865x_read_regs(priv, LAN865X_REG_MAC_NET_CTL, &reg_val, 1);
+	last_addr = priv->last_reg_addr;
+	last_value = priv->last_reg_value;
+	lan865x_reg_unlock(priv);
 	if (ret) {
 		len = snprintf(buf, sizeof(buf), "Error reading MAC_NET_CTL: %d\n", ret);
 		goto out;
@@ -375,7 +2411,7 @@ static ssize_t lan865x_debugfs_reg_read(struct file *file, char __user *user_buf
 		       LAN865X_REG_MAC_NET_CTL, reg_val,
 		       (reg_val & MAC_NET_CTL_TXEN) ? "ON" : "OFF",
 		       (reg_val & MAC_NET_CTL_RXEN) ? "ON" : "OFF",
-		       priv->last_reg_addr, priv->last_reg_value,
+		       last_addr, last_value,
 		       priv->debug_enabled ? "YES" : "NO");
 
 out:
@@ -406,36 +2442,44 @@ static ssize_t lan865x_debugfs_reg_write(struct file *file, const char __user *u
 	/* Parse input: "addr" for read, "addr value" for write */
 	args = sscanf(buf, "%x %x", &addr, &value);
 	
+	if (args != 1 && args != 2) {
+		dev_err(&priv->spi->dev, "Invalid format. Use: 'addr [value]'\n");
+		return -EINVAL;
+	}
+
+	/* Access and last accessed record are updated as one unit */
+	lan865x_reg_lock(priv);
+
 	if (args == 1) {
 		/* Read operation */
-		ret = oa_tc6_read_register(priv->tc6, addr, &value);
+		ret = __lan865x_read_regs(priv, addr, &value, 1);
 		if (ret) {
 			dev_err(&priv->spi->dev, "Failed to read register 0x%08x: %d\n", addr, ret);
-			return ret;
+			goto unlock;
 		}
 		priv->last_reg_addr = addr;
 		priv->last_reg_value = value;
 #ifdef CONFIG_LAN865X_DEBUG_VERBOSE
 		dev_info(&priv->spi->dev, "REG_READ: 0x%08x = 0x%08x\n", addr, value);
 #endif
-	} else if (args == 2) {
+	} else {
 		/* Write operation */
-		ret = oa_tc6_write_register(priv->tc6, addr, value);
+		ret = __lan865x_write_reg(priv, addr, value);
 		if (ret) {
 			dev_err(&priv->spi->dev, "Failed to write register 0x%08x: %d\n", addr, ret);
-			return ret;
+			goto unlock;
 		}
 		priv->last_reg_addr = addr;
 		priv->last_reg_value = value;
 #ifdef CONFIG_LAN865X_DEBUG_VERBOSE
 		dev_info(&priv->spi->dev, "REG_WRITE: 0x%08x = 0x%08x\n", addr, value);
 #endif
-	} else {
-		dev_err(&priv->spi->dev, "Invalid format. Use: 'addr [value]'\n");
-		return -EINVAL;
 	}
-	
-	return count;
+
+unlock:
+	lan865x_reg_unlock(priv);
+
+	return ret ? ret : count;
 }
 
 static const struct file_operations lan865x_debugfs_reg_fops = {
@@ -445,6 +2489,123 @@ static const struct file_operations lan865x_debugfs_reg_fops = {
 	.llseek = default_llseek,
 };
 
+static int lan865x_debugfs_bufsts_show(struct seq_file *s, void *unused)
+{
+	struct lan865x_priv *priv = s->private;
+	struct lan865x_bufsts *bufsts = &priv->bufsts;
+
+	seq_printf(s, "samples: %llu\n", bufsts->samples);
+	seq_printf(s, "txbue_events: %llu\n", bufsts->txbue_events);
+	seq_printf(s, "interval_ms: %u\n", READ_ONCE(bufsts->interval_ms));
+	seq_printf(s, "adaptive: %s\n",
+		   READ_ONCE(bufsts->adaptive) ? "on" : "off");
+	seq_printf(s, "stop_thresh: %u\n", READ_ONCE(bufsts->stop_thresh));
+	seq_printf(s, "wake_thresh: %u\n", READ_ONCE(bufsts->wake_thresh));
+	seq_printf(s, "stop_limit: %u\n", bufsts->stop_limit);
+	seq_printf(s, "txc_max: %u\n", bufsts->txc_max);
+	seq_printf(s, "queue_stopped: %s\n",
+		   READ_ONCE(bufsts->queue_stopped) ? "yes" : "no");
+	seq_puts(s, "\ncount      TXC        RBA\n");
+	for (int i = 0; i < LAN865X_BUFSTS_BUCKETS; i++)
+		seq_printf(s, "%2d%s  %10llu %10llu\n", i,
+			   i == LAN865X_BUFSTS_BUCKETS - 1 ? "+" : " ",
+			   bufsts->txc_hist[i], bufsts->rba_hist[i]);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lan865x_debugfs_bufsts);
+
+static int lan865x_debugfs_bufsts_interval_get(void *data, u64 *val)
+{
+	struct lan865x_priv *priv = data;
+
+	*val = READ_ONCE(priv->bufsts.interval_ms);
+
+	return 0;
+}
+
+static int lan865x_debugfs_bufsts_interval_set(void *data, u64 val)
+{
+	struct lan865x_priv *priv = data;
+
+	if (val > MSEC_PER_SEC)
+		return -EINVAL;
+
+	WRITE_ONCE(priv->bufsts.interval_ms, val);
+	if (val && netif_running(priv->netdev))
+		mod_delayed_work(system_wq, &priv->bufsts.work, 0);
+
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(lan865x_debugfs_bufsts_interval_fops,
+			 lan865x_debugfs_bufsts_interval_get,
+			 lan865x_debugfs_bufsts_interval_set, "%llu\n");
+
+static int lan865x_debugfs_snapshots_show(struct seq_file *s, void *unused)
+{
+	struct lan865x_priv *priv = s->private;
+	struct lan865x_snapshot *snap = &priv->snapshot;
+	int i;
+
+	seq_printf(s, "taken: %llu\n", snap->taken);
+	seq_printf(s, "failed: %llu\n", snap->failed);
+	seq_printf(s, "rate_limited: %d\n", atomic_read(&snap->rate_limited));
+	seq_printf(s, "last_id: %u\n", snap->last_id);
+	seq_puts(s, "last_reasons:");
+	for_each_set_bit(i, &snap->last_reasons,
+			 ARRAY_SIZE(lan865x_snapshot_reasons))
+		seq_printf(s, " %s", lan865x_snapshot_reasons[i]);
+	seq_putc(s, '\n');
+	seq_printf(s, "status0: 0x%08x\n", snap->status0);
+	seq_printf(s, "status1: 0x%08x\n", snap->status1);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lan865x_debugfs_snapshots);
+
+static int lan865x_debugfs_pm_show(struct seq_file *s, void *unused)
+{
+	struct lan865x_priv *priv = s->private;
+	struct lan865x_pm *pm = &priv->pm;
+
+	seq_printf(s, "resumes: %u\n", pm->resumes);
+	seq_printf(s, "power_lost: %u\n", pm->power_lost);
+	seq_printf(s, "restore_us: %u\n", pm->restore_us);
+	seq_printf(s, "restore_us_max: %u\n", pm->restore_us_max);
+	seq_printf(s, "resume_us: %u\n", pm->resume_us);
+	seq_printf(s, "first_xmit_us: %u\n", READ_ONCE(pm->first_xmit_us));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lan865x_debugfs_pm);
+
+static int lan865x_debugfs_reg_lock_show(struct seq_file *s, void *unused)
+{
+	struct lan865x_priv *priv = s->private;
+	struct lan865x_reg_stats st;
+
+	/* Consistent copy; the lock is never held for long */
+	lan865x_reg_lock(priv);
+	st = priv->reg_stats;
+	lan865x_reg_unlock(priv);
+
+	seq_printf(s, "acquired: %llu\n", st.acquired);
+	seq_printf(s, "contended: %llu\n", st.contended);
+	seq_printf(s, "wait_ns_total: %llu\n", st.wait_ns);
+	seq_printf(s, "wait_ns_max: %llu\n", st.wait_ns_max);
+	seq_printf(s, "hold_ns_total: %llu\n", st.hold_ns);
+	seq_printf(s, "hold_ns_max: %llu\n", st.hold_ns_max);
+	if (st.acquired) {
+		seq_printf(s, "wait_ns_avg: %llu\n",
+			   div64_u64(st.wait_ns, st.acquired));
+		seq_printf(s, "hold_ns_avg: %llu\n",
+			   div64_u64(st.hold_ns, st.acquired));
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lan865x_debugfs_reg_lock);
+
 static void lan865x_debugfs_init(struct lan865x_priv *priv)
 {
 	priv->debugfs_dir = debugfs_create_dir("lan865x", NULL);
@@ -455,6 +2616,19 @@ static void lan865x_debugfs_init(struct lan865x_priv *priv)
 						priv, &lan865x_debugfs_reg_fops);
 						
 	debugfs_create_bool("debug_enable", 0600, priv->debugfs_dir, &priv->debug_enabled);
+
+	debugfs_create_file("bufsts", 0400, priv->debugfs_dir, priv,
+			    &lan865x_debugfs_bufsts_fops);
+	debugfs_create_file_unsafe("bufsts_interval_ms", 0600, priv->debugfs_dir,
+				   priv, &lan865x_debugfs_bufsts_interval_fops);
+	debugfs_create_bool("bufsts_adaptive", 0600, priv->debugfs_dir,
+			    &priv->bufsts.adaptive);
+	debugfs_create_file("snapshots", 0400, priv->debugfs_dir, priv,
+			    &lan865x_debugfs_snapshots_fops);
+	debugfs_create_file("pm", 0400, priv->debugfs_dir, priv,
+			    &lan865x_debugfs_pm_fops);
+	debugfs_create_file("reg_lock", 0400, priv->debugfs_dir, priv,
+			    &lan865x_debugfs_reg_lock_fops);
 	
 	priv->debug_enabled = true;  /* Enable by default */
 }
@@ -478,12 +2652,42 @@ static int lan865x_probe(struct spi_device *spi)
 	priv->netdev = netdev;
 	priv->spi = spi;
 	spi_set_drvdata(spi, priv);
+
+	priv->stats = netdev_alloc_pcpu_stats(struct lan865x_pcpu_stats);
+	if (!priv->stats) {
+		ret = -ENOMEM;
+		goto free_netdev;
+	}
+
+	mutex_init(&priv->reg_lock);
 	INIT_WORK(&priv->multicast_work, lan865x_multicast_work_handler);
+	INIT_DELAYED_WORK(&priv->bufsts.work, lan865x_bufsts_work_handler);
+	INIT_WORK(&priv->bufsts.poll, lan865x_bufsts_poll_handler);
+	hrtimer_init(&priv->bufsts.timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	priv->bufsts.timer.function = lan865x_bufsts_timer;
+	mutex_init(&priv->bufsts.lock);
+	priv->bufsts.interval_ms = LAN865X_BUFSTS_INTERVAL_MS;
+	priv->bufsts.stop_thresh = LAN865X_TXC_STOP_THRESH;
+	priv->bufsts.wake_thresh = LAN865X_TXC_STOP_THRESH +
+				   LAN865X_TXC_HYSTERESIS;
+	priv->bufsts.stop_limit = LAN865X_TXC_STOP_THRESH_MAX;
+	u64_stats_init(&priv->plca.syncp);
+	hrtimer_init(&priv->coal.timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	priv->coal.timer.function = lan865x_coal_timer;
+	priv->coal.rx_max_frames = LAN865X_COAL_RX_FRAMES;
+	u64_stats_init(&priv->coal.syncp);
 
 	priv->tc6 = oa_tc6_init(spi, netdev);
 	if (!priv->tc6) {
 		ret = -ENODEV;
-		goto free_netdev;
+		goto free_stats;
+	}
+
+	ret = lan865x_snapshot_init(priv);
+	if (ret) {
+		dev_err(&spi->dev, "Failed to create devlink regions: %d\n",
+			ret);
+		goto oa_tc6_exit;
 	}
 
 	/* LAN865x Rev.B0/B1 configuration parameters from AN1760
@@ -493,12 +2697,12 @@ static int lan865x_probe(struct spi_device *spi)
 	 * stamping at the end of the Start of Frame Delimiter (SFD) and set the
 	 * Timer Increment reg to 40 ns to be used as a 25 MHz internal clock.
 	 */
-	ret = oa_tc6_write_register(priv->tc6, LAN865X_REG_MAC_TSU_TIMER_INCR,
-				    MAC_TSU_TIMER_INCR_COUNT_NANOSECONDS);
+	ret = lan865x_write_reg(priv, LAN865X_REG_MAC_TSU_TIMER_INCR,
+				MAC_TSU_TIMER_INCR_COUNT_NANOSECONDS);
 	if (ret) {
 		dev_err(&spi->dev, "Failed to config TSU Timer Incr reg: %d\n",
 			ret);
-		goto oa_tc6_exit;
+		goto snapshot_exit;
 	}
 
 	/* As per the point s3 in the below errata, SPI receive Ethernet frame
@@ -516,7 +2720,7 @@ static int lan865x_probe(struct spi_device *spi)
 	ret = oa_tc6_zero_align_receive_frame_enable(priv->tc6);
 	if (ret) {
 		dev_err(&spi->dev, "Failed to set ZARFE: %d\n", ret);
-		goto oa_tc6_exit;
+		goto snapshot_exit;
 	}
 
 	/* Get the MAC address from the SPI device tree node */
@@ -526,7 +2730,7 @@ static int lan865x_probe(struct spi_device *spi)
 	ret = lan865x_set_hw_macaddr(priv, netdev->dev_addr);
 	if (ret) {
 		dev_err(&spi->dev, "Failed to configure MAC: %d\n", ret);
-		goto oa_tc6_exit;
+		goto snapshot_exit;
 	}
 
 	netdev->if_port = IF_PORT_10BASET;
@@ -537,19 +2741,34 @@ static int lan865x_probe(struct spi_device *spi)
 	/* Initialize debugfs interface */
 	lan865x_debugfs_init(priv);
 
+	/* Suspended whenever the interface is down */
+	pm_runtime_set_active(&spi->dev);
+	pm_runtime_enable(&spi->dev);
+
 	ret = register_netdev(netdev);
 	if (ret) {
 		dev_err(&spi->dev, "Register netdev failed (ret = %d)", ret);
-		goto debugfs_cleanup;
+		goto pm_disable;
 	}
 
+	devlink_register(priv->snapshot.devlink);
+
 	return 0;
 
-debugfs_cleanup:
+pm_disable:
+	pm_runtime_disable(&spi->dev);
+	pm_runtime_set_suspended(&spi->dev);
 	lan865x_debugfs_remove(priv);
 
+snapshot_exit:
+	lan865x_snapshot_exit(priv);
+
 oa_tc6_exit:
 	oa_tc6_exit(priv->tc6);
+free_stats:
+	mutex_destroy(&priv->bufsts.lock);
+	mutex_destroy(&priv->reg_lock);
+	free_percpu(priv->stats);
 free_netdev:
 	free_netdev(priv->netdev);
 	return ret;
@@ -559,13 +2778,191 @@ static void lan865x_remove(struct spi_device *spi)
 {
 	struct lan865x_priv *priv = spi_get_drvdata(spi);
 
+	devlink_unregister(priv->snapshot.devlink);
+	pm_runtime_disable(&spi->dev);
 	cancel_work_sync(&priv->multicast_work);
 	unregister_netdev(priv->netdev);
+	/* A transmit racing with close may have kicked one more hold poll */
+	cancel_work_sync(&priv->bufsts.poll);
+	pm_runtime_set_suspended(&spi->dev);
 	lan865x_debugfs_remove(priv);
+	lan865x_snapshot_exit(priv);
 	oa_tc6_exit(priv->tc6);
+	mutex_destroy(&priv->bufsts.lock);
+	mutex_destroy(&priv->reg_lock);
+	free_percpu(priv->stats);
 	free_netdev(priv->netdev);
 }
 
+static int __lan865x_pm_save(struct lan865x_priv *priv)
+{
+	struct lan865x_pm *pm = &priv->pm;
+	int ret;
+
+	ret = __lan865x_read_regs(priv, LAN865X_REG_OA_CONFIG0, &pm->config0,
+				  1);
+	if (ret)
+		return ret;
+
+	ret = __lan865x_read_regs(priv, LAN865X_REG_OA_IMASK0, pm->imask,
+				  ARRAY_SIZE(pm->imask));
+	if (ret)
+		return ret;
+
+	ret = __lan865x_read_regs(priv, LAN865X_REG_MAC_L_HASH, pm->mac_filter,
+				  ARRAY_SIZE(pm->mac_filter));
+	if (ret)
+		return ret;
+
+	ret = __lan865x_read_regs(priv, LAN865X_REG_MAC_NET_CTL, pm->mac_ctl,
+				  ARRAY_SIZE(pm->mac_ctl));
+	if (ret)
+		return ret;
+
+	/* Keep the MAC quiet while suspended */
+	pm->mac_ctl[0] &= ~(MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN);
+
+	return __lan865x_write_reg(priv, LAN865X_REG_MAC_NET_CTL,
+				   pm->mac_ctl[0]);
+}
+
+static int __lan865x_pm_restore(struct lan865x_priv *priv, bool up)
+{
+	struct lan865x_pm *pm = &priv->pm;
+	u32 mac_ctl[2];
+	u32 status0;
+	int ret;
+
+	ret = __lan865x_read_regs(priv, LAN865X_REG_OA_STATUS0, &status0, 1);
+	if (ret)
+		return ret;
+
+	/* The MAC-PHY lost power: also bring back the interrupt masks that
+	 * oa_tc6 set up at probe time.
+	 */
+	if (status0 & OA_STATUS0_RESETC) {
+		pm->power_lost++;
+
+		ret = __lan865x_write_reg(priv, LAN865X_REG_OA_STATUS0,
+					  OA_STATUS0_RESETC);
+		if (ret)
+			return ret;
+
+		ret = __lan865x_write_regs(priv, LAN865X_REG_OA_IMASK0,
+					   pm->imask, ARRAY_SIZE(pm->imask));
+		if (ret)
+			return ret;
+	}
+
+	/* Holds ZARFE and the data transfer enable */
+	ret = __lan865x_write_reg(priv, LAN865X_REG_OA_CONFIG0, pm->config0);
+	if (ret)
+		return ret;
+
+	ret = __lan865x_write_reg(priv, LAN865X_REG_MAC_TSU_TIMER_INCR,
+				  MAC_TSU_TIMER_INCR_COUNT_NANOSECONDS);
+	if (ret)
+		return ret;
+
+	ret = __lan865x_write_regs(priv, LAN865X_REG_MAC_L_HASH,
+				   pm->mac_filter, ARRAY_SIZE(pm->mac_filter));
+	if (ret)
+		return ret;
+
+	/* Network configuration and enable last, so no frame is received
+	 * before the filters are in place.
+	 */
+	mac_ctl[0] = pm->mac_ctl[0];
+	mac_ctl[1] = pm->mac_ctl[1];
+	if (up)
+		mac_ctl[0] |= MAC_NET_CTL_TXEN | MAC_NET_CTL_RXEN;
+
+	return __lan865x_write_regs(priv, LAN865X_REG_MAC_NET_CTL, mac_ctl,
+				    ARRAY_SIZE(mac_ctl));
+}
+
+static void lan865x_pm_start(struct lan865x_priv *priv)
+{
+	phy_start(priv->netdev->phydev);
+	lan865x_bufsts_start(priv);
+	lan865x_coal_start(priv);
+	lan865x_snapshot_watch_start(priv);
+	netif_device_attach(priv->netdev);
+}
+
+/* Runtime suspend happens whenever the interface is down; system sleep
+ * goes through the same path via pm_runtime_force_suspend().
+ */
+static int lan865x_runtime_suspend(struct device *dev)
+{
+	struct lan865x_priv *priv = dev_get_drvdata(dev);
+	struct net_device *netdev = priv->netdev;
+	struct lan865x_pm *pm = &priv->pm;
+	int ret;
+
+	pm->was_up = netif_running(netdev);
+	if (pm->was_up) {
+		/* Keep transmits from kicking the hold poll again */
+		netif_device_detach(netdev);
+		lan865x_snapshot_watch_stop(priv);
+		lan865x_coal_stop(priv);
+		lan865x_bufsts_stop(priv);
+		phy_stop(netdev->phydev);
+	}
+
+	/* No SPI transfers from deferred work once suspended */
+	flush_work(&priv->multicast_work);
+	flush_work(&priv->snapshot.work);
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_pm_save(priv);
+	lan865x_reg_unlock(priv);
+	if (ret) {
+		dev_err(dev, "Failed to save configuration: %d\n", ret);
+		if (pm->was_up)
+			lan865x_pm_start(priv);
+		return ret;
+	}
+
+	phy_suspend(netdev->phydev);
+
+	return 0;
+}
+
+static int lan865x_runtime_resume(struct device *dev)
+{
+	struct lan865x_priv *priv = dev_get_drvdata(dev);
+	struct lan865x_pm *pm = &priv->pm;
+	ktime_t start = ktime_get();
+	int ret;
+
+	lan865x_reg_lock(priv);
+	ret = __lan865x_pm_restore(priv, pm->was_up);
+	lan865x_reg_unlock(priv);
+	if (ret) {
+		dev_err(dev, "Failed to restore configuration: %d\n", ret);
+		return ret;
+	}
+
+	pm->restore_us = ktime_us_delta(ktime_get(), start);
+	pm->restore_us_max = max(pm->restore_us_max, pm->restore_us);
+
+	/* phy_start() resumes the PHY, otherwise ndo_open will */
+	if (pm->was_up) {
+		pm->resume_start = start;
+		set_bit(LAN865X_PM_FIRST_XMIT, &pm->flags);
+		lan865x_pm_start(priv);
+	}
+
+	pm->resume_us = ktime_us_delta(ktime_get(), start);
+	pm->resumes++;
+
+	return 0;
+}
+
+static DEFINE_RUNTIME_DEV_PM_OPS(lan865x_pm_ops, lan865x_runtime_suspend,
+				 lan865x_runtime_resume, NULL);
+
 static const struct spi_device_id lan865x_ids[] = {
 	{ .name = "lan8650" },
 	{ .name = "lan8651" },
@@ -584,12 +2981,35 @@ static struct spi_driver lan865x_driver = {
 	.driver = {
 		.name = DRV_NAME,
 		.of_match_table = lan865x_dt_ids,
+		.pm = pm_ptr(&lan865x_pm_ops),
 	 },
 	.probe = lan865x_probe,
 	.remove = lan865x_remove,
 	.id_table = lan865x_ids,
 };
-module_spi_driver(lan865x_driver);
+
+static int __init lan865x_init(void)
+{
+	int ret;
+
+	ret = genl_register_family(&lan865x_genl_family);
+	if (ret)
+		return ret;
+
+	ret = spi_register_driver(&lan865x_driver);
+	if (ret)
+		genl_unregister_family(&lan865x_genl_family);
+
+	return ret;
+}
+module_init(lan865x_init);
+
+static void __exit lan865x_exit(void)
+{
+	spi_unregister_driver(&lan865x_driver);
+	genl_unregister_family(&lan865x_genl_family);
+}
+module_exit(lan865x_exit);
 
 MODULE_DESCRIPTION(DRV_NAME " 10Base-T1S MACPHY Ethernet Driver");
 MODULE_AUTHOR("Parthiban Veerasooran <parthiban.veerasooran@microchip.com>");
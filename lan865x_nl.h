@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: GPL-2.0+ WITH Linux-syscall-note */
+/*
+ * Generic netlink register access interface of the LAN865x driver
+ *
+ * Shared between the driver and the userspace register access tools.
+ */
+
+#ifndef _LAN865X_NL_H
+#define _LAN865X_NL_H
+
+#define LAN865X_GENL_NAME		"lan865x"
+#define LAN865X_GENL_VERSION		1
+
+/* Registers per LAN865X_ATTR_REG block, matching one OA-TC6 control
+ * transaction of consecutive registers.
+ */
+#define LAN865X_NL_MAX_BLOCK_REGS	128
+/* Registers per message, summed over all blocks */
+#define LAN865X_NL_MAX_MSG_REGS		1024
+
+/* Both commands carry LAN865X_ATTR_IFINDEX and one or more LAN865X_ATTR_REG
+ * blocks. A read block holds ADDR and COUNT, and is answered with ADDR and
+ * VALUES. A write block holds ADDR and VALUES. Blocks are executed in order
+ * and cover COUNT consecutive registers starting at ADDR; VALUES is an array
+ * of host endian __u32.
+ */
+enum lan865x_nl_cmd {
+	LAN865X_CMD_UNSPEC,
+	LAN865X_CMD_REG_READ,
+	LAN865X_CMD_REG_WRITE,
+
+	__LAN865X_CMD_MAX,
+	LAN865X_CMD_MAX = __LAN865X_CMD_MAX - 1,
+};
+
+enum lan865x_nl_attr {
+	LAN865X_ATTR_UNSPEC,
+	LAN865X_ATTR_IFINDEX,		/* u32 */
+	LAN865X_ATTR_REG,		/* nested, may be repeated */
+
+	__LAN865X_ATTR_MAX,
+	LAN865X_ATTR_MAX = __LAN865X_ATTR_MAX - 1,
+};
+
+enum lan865x_nl_reg_attr {
+	LAN865X_REG_ATTR_UNSPEC,
+	LAN865X_REG_ATTR_ADDR,		/* u32 */
+	LAN865X_REG_ATTR_COUNT,		/* u32, reads only */
+	LAN865X_REG_ATTR_VALUES,	/* binary, __u32 array */
+
+	__LAN865X_REG_ATTR_MAX,
+	LAN865X_REG_ATTR_MAX = __LAN865X_REG_ATTR_MAX - 1,
+};
+
+#endif /* _LAN865X_NL_H */